@@ -11,3 +11,20 @@ void AresCRT::wstrCopy(wchar_t *Dest, const wchar_t *Source, size_t Count) {
 	wcsncpy_s(Dest, Count, Source, Count - 1);
 	Dest[Count - 1] = 0;
 }
+
+size_t AresCRT::strHashI(const char *String) {
+	// FNV-1a over the upper case chars
+	size_t hash = 2166136261u;
+	for(auto p = String; *p; ++p) {
+		auto c = static_cast<unsigned char>(*p);
+		if(c >= 'a' && c <= 'z') {
+			c -= 'a' - 'A';
+		}
+		hash = (hash ^ c) * 16777619u;
+	}
+	return hash;
+}
+
+bool AresCRT::StrEqualI::operator () (const char *Left, const char *Right) const {
+	return !_strcmpi(Left, Right);
+}
@@ -21,4 +21,18 @@ public:
 	static void wstrCopy(wchar_t (&Dest)[Size], const wchar_t *Source) {
 		wstrCopy(Dest, Source, Size);
 	}
+
+	// hash and equality for C strings that ignore the case of ASCII letters,
+	// like _strcmpi does. use these to key hashed containers by names
+	static size_t strHashI(const char *String);
+
+	struct StrHashI {
+		size_t operator () (const char *String) const {
+			return strHashI(String);
+		}
+	};
+
+	struct StrEqualI {
+		bool operator () (const char *Left, const char *Right) const;
+	};
 };
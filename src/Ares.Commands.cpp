@@ -7,8 +7,11 @@
 #include "Commands/MapSnapshot.h"
 //include "Commands/FrameByFrame.h"
 #include "Commands/AIBasePlan.h"
+#include "Commands/AIProduction.h"
 #include "Commands/DumpTypes.h"
 #include "Commands/DumpMemory.h"
+#include "Commands/DumpVerses.h"
+#include "Commands/DumpPrismNetworks.h"
 //#include "Commands/Debugging.h"
 //include "Commands/Logging.h"
 #include "Commands/FPSCounter.h"
@@ -23,8 +26,11 @@ void Ares::RegisterCommands()
 	//MakeCommand<TestSomethingCommandClass>();
 	MakeCommand<DumperTypesCommandClass>();
 	MakeCommand<MemoryDumperCommandClass>();
+	MakeCommand<VersesDumperCommandClass>();
+	MakeCommand<PrismNetworksDumperCommandClass>();
 	//MakeCommand<DebuggingCommandClass>();
 	MakeCommand<AIBasePlanCommandClass>();
+	MakeCommand<AIProductionCommandClass>();
 	MakeCommand<FPSCounterCommandClass>();
 	MakeCommand<TogglePowerCommandClass>();
 }
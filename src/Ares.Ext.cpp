@@ -24,7 +24,10 @@
 #include "Enum/Prerequisites.h"
 #include "Enum/RadTypes.h"
 
+#include "Misc/JammerClass.h"
 #include "Misc/SWTypes.h"
+#include "Misc/TechnoCounters.h"
+#include "Misc/TechnoGrid.h"
 
 #include <utility>
 
@@ -215,7 +218,10 @@ auto MassActions = MassAction<
 	GenericPrerequisite,
 	RadType,
 	NewSWType, // other classes
-	SWStateMachine
+	SWStateMachine,
+	JammerClass,
+	TechnoGrid,
+	TechnoCounters
 >();
 
 DEFINE_HOOK(7258D0, AnnounceInvalidPointer, 6)
@@ -248,6 +254,15 @@ void Ares::PointerGotInvalid(
 }
 
 HRESULT Ares::SaveGameData(IStream *pStm) {
+	Debug::Log("Saving Ares object data\n");
+
+	auto const written = ContainerBlockStore::Instance.WriteToStream(pStm);
+	ContainerBlockStore::Instance.Clear();
+
+	if(!written) {
+		return E_FAIL;
+	}
+
 	Debug::Log("Saving global Ares data\n");
 
 	if(!MassActions.Save(pStm)) {
@@ -259,11 +274,22 @@ HRESULT Ares::SaveGameData(IStream *pStm) {
 }
 
 void Ares::LoadGameData(IStream *pStm) {
+	Debug::Log("Loading Ares object data\n");
+
+	auto const read = ContainerBlockStore::Instance.ReadFromStream(pStm);
+	ContainerBlockStore::Instance.Clear();
+
+	// the game objects are loaded already, there is no way to continue
+	// with objects lacking their extension
+	if(!read) {
+		Debug::FatalErrorAndExit("Error loading the Ares object data\n");
+	}
+
 	Debug::Log("Loading global Ares data\n");
 
 	if(!MassActions.Load(pStm)) {
-		Debug::Log("Error loading the game\n");
-	} else {
-		Debug::Log("Finished loading the game\n");
+		Debug::FatalErrorAndExit("Error loading the global Ares data\n");
 	}
+
+	Debug::Log("Finished loading the game\n");
 }
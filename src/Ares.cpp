@@ -6,11 +6,14 @@
 #include <Unsorted.h>
 #include <GetCDClass.h>
 
+#include <algorithm>
 #include <new>
 
+#include "Ext/_Container.hpp"
 #include "Misc/Debug.h"
 #include "Misc/EMPulse.h"
 #include "Misc/Exception.h"
+#include "Misc/IniSectionIncludes.h"
 
 #ifdef IS_RELEASE_VER
 const auto IsStable = true;
@@ -31,6 +34,7 @@ bool Ares::bFPSCounter = false;
 bool const Ares::bStable = IsStable;
 bool Ares::bStableNotification = false;
 bool Ares::bOutputMissingStrings = false;
+bool Ares::bBinarySyncLog = false;
 bool Ares::bShuttingDown = false;
 
 char Ares::readBuffer[Ares::readLength];
@@ -81,8 +85,16 @@ void __stdcall Ares::CmdLineParse(char** ppArgs, int nNumArgs)
 			bAllowAIControl = true;
 		} else if(_stricmp(pArg, "-LOG-CSF") == 0) {
 			bOutputMissingStrings = true;
+		} else if(_stricmp(pArg, "-LOG-INHERITANCE") == 0) {
+			IniSectionIncludes::LogInheritance = true;
+		} else if(_stricmp(pArg, "-BINARYSYNC") == 0) {
+			bBinarySyncLog = true;
 		} else if(_stricmp(pArg, "-EXCEPTION") == 0) {
 			ExceptionMode = ExceptionHandlerMode::NoRemove;
+		} else if(_strnicmp(pArg, "-LOGBUFFER=", 11) == 0) {
+			// in KiB, zero writes the log unbuffered
+			auto const size = atoi(pArg + 11);
+			Debug::LogBufferSize = static_cast<size_t>(std::max(size, 0)) * 1024;
 		}
 	}
 
@@ -368,10 +380,12 @@ wchar_t const* Ares::GetStabilityWarning()
 
 void Ares::SaveGame() {
 	Debug::Log("About to save the game\n");
+	ContainerBlockStore::Instance.Clear();
 }
 
 void Ares::LoadGame() {
 	Debug::Log("About to load the game\n");
+	ContainerBlockStore::Instance.Clear();
 }
 
 const DWORD YR_SIZE_1000 = 0x496110;
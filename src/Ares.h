@@ -76,6 +76,8 @@ public:
 
 	static bool bOutputMissingStrings;
 
+	static bool bBinarySyncLog;
+
 	static int TrackIndex;
 
 	static PVOID pExceptionHandler;
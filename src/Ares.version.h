@@ -7,7 +7,10 @@
 #define VERSION_MINOR 2
 #define VERSION_REVISION 813
 
-#define SAVEGAME_MAGIC ((VERSION_MAJOR << 24) | (VERSION_MINOR << 12) | (VERSION_REVISION))
+// increase when the layout of the saved Ares data changes within a version
+#define SAVEGAME_REVISION 2
+
+#define SAVEGAME_MAGIC ((VERSION_MAJOR << 24) | (SAVEGAME_REVISION << 20) | (VERSION_MINOR << 12) | (VERSION_REVISION))
 
 #define wstr(x) wstr_(x)
 #define wstr_(x) L ## #x
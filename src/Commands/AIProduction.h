@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Ares.h"
+#include "Commands/Commands.h"
+
+#include "../Ext/House/Body.h"
+#include "../Misc/Debug.h"
+
+#include <AircraftClass.h>
+#include <AircraftTypeClass.h>
+#include <HouseClass.h>
+#include <HouseTypeClass.h>
+#include <InfantryClass.h>
+#include <InfantryTypeClass.h>
+#include <MessageListClass.h>
+#include <RulesClass.h>
+#include <ScenarioClass.h>
+#include <TeamClass.h>
+#include <TeamTypeClass.h>
+#include <UnitClass.h>
+#include <UnitTypeClass.h>
+
+#include "../Ext/House/MacroHacks.h"
+
+#include <vector>
+
+class AIProductionCommandClass : public AresCommandClass
+{
+public:
+	//CommandClass
+	virtual const char* GetName() const override
+	{
+		return "Dump AI Production Demand";
+	}
+
+	virtual const wchar_t* GetUIName() const override
+	{
+		return L"AI Production Demand Logger";
+	}
+
+	virtual const wchar_t* GetUICategory() const override
+	{
+		return L"Development";
+	}
+
+	virtual const wchar_t* GetUIDescription() const override
+	{
+		return L"Dumps the types the AI teams are waiting for to the log";
+	}
+
+	virtual void Execute(DWORD dwUnk) const override
+	{
+		if(this->CheckDebugDeactivated()) {
+			return;
+		}
+
+		Debug::Log("AI Production Demand:\n");
+		for(int i = 0; i < HouseClass::Array->Count; ++i) {
+			auto H = HouseClass::Array->GetItem(i);
+			if(!H->ControlledByHuman()) {
+				Debug::Log("#%02d: country %25s:\n", i, H->Type->ID);
+				DumpDemand<UnitClass, UnitTypeClass>(H, "Unit");
+				DumpDemand<InfantryClass, InfantryTypeClass>(H, "Infantry");
+				DumpDemand<AircraftClass, AircraftTypeClass>(H, "Aircraft");
+				Debug::Log("\n");
+			}
+		}
+
+		MessageListClass::Instance->PrintMessage(L"Dumped AI Production Demand");
+	}
+
+private:
+	template <class TClass, class TType>
+	static void DumpDemand(HouseClass* pHouse, const char* pKind)
+	{
+		std::vector<int> Values;
+		std::vector<int> CreationFrames;
+
+		auto const& Demanded = CountTypeDemand<TClass, TType>(pHouse, Values, CreationFrames);
+		for(auto const idx : Demanded) {
+			auto const i = static_cast<unsigned int>(idx);
+			// the recruitable objects may cover all of it
+			if(Values[i] <= 0) {
+				continue;
+			}
+			Debug::Log("\t%s %s: missing %d, earliest team created in frame %d\n",
+				pKind, TType::Array->GetItem(idx)->ID, Values[i], CreationFrames[i]);
+		}
+	}
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Commands.h"
+
+#include "../Ext/Building/Body.h"
+#include "../Misc/Debug.h"
+
+#include <MessageListClass.h>
+
+class PrismNetworksDumperCommandClass : public AresCommandClass
+{
+public:
+	//CommandClass
+	virtual const char* GetName() const override
+	{
+		return "Dump Prism Networks";
+	}
+
+	virtual const wchar_t* GetUIName() const override
+	{
+		return L"Dump Prism Networks";
+	}
+
+	virtual const wchar_t* GetUICategory() const override
+	{
+		return L"Development";
+	}
+
+	virtual const wchar_t* GetUIDescription() const override
+	{
+		return L"Dumps the towers supporting each charging prism tower to the log";
+	}
+
+	virtual void Execute(DWORD dwUnk) const override
+	{
+		if(this->CheckDebugDeactivated()) {
+			return;
+		}
+
+		Debug::Log("Prism Forwarding Networks:\n");
+		BuildingExt::cPrismForwarding::LogNetworks();
+
+		MessageListClass::Instance->PrintMessage(L"Prism networks dumped");
+	}
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Commands.h"
+
+#include "../Ext/WarheadType/Body.h"
+
+#include <MessageListClass.h>
+
+class VersesDumperCommandClass : public AresCommandClass
+{
+public:
+	//CommandClass
+	virtual const char* GetName() const override
+	{
+		return "Dump Verses";
+	}
+
+	virtual const wchar_t* GetUIName() const override
+	{
+		return L"Dump Verses";
+	}
+
+	virtual const wchar_t* GetUICategory() const override
+	{
+		return L"Development";
+	}
+
+	virtual const wchar_t* GetUIDescription() const override
+	{
+		return L"Saves the verses of all warheads against all armors as a CSV file.";
+	}
+
+	virtual void Execute(DWORD dwUnk) const override
+	{
+		if(this->CheckDebugDeactivated()) {
+			return;
+		}
+
+		char fName[0x80];
+
+		SYSTEMTIME time;
+		GetLocalTime(&time);
+
+		_snprintf_s(fName, 0x7F, "Verses.%04u%02u%02u-%02u%02u%02u-%05u.csv",
+			time.wYear, time.wMonth, time.wDay, time.wHour, time.wMinute, time.wSecond, time.wMilliseconds);
+
+		wchar_t msg[0xA0] = L"\0";
+		if(WarheadTypeExt::VersesTable::WriteCSV(fName)) {
+			wsprintfW(msg, L"Verses saved as '%hs'.", fName);
+		} else {
+			wsprintfW(msg, L"Verses could not be saved as '%hs'.", fName);
+		}
+
+		MessageListClass::Instance->PrintMessage(msg);
+	}
+};
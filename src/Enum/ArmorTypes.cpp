@@ -5,6 +5,7 @@
 #include <Conversions.h>
 
 Enumerable<ArmorType>::container_t Enumerable<ArmorType>::Array;
+Enumerable<ArmorType>::index_t Enumerable<ArmorType>::Index;
 
 const char * Enumerable<ArmorType>::GetMainSection()
 {
@@ -27,6 +28,8 @@ void ArmorType::LoadFromINI(CCINIClass *pINI)
 	this->DefaultIndex = ArmorType::FindIndex(buffer);
 	WarheadTypeExt::VersesData *VS = &this->DefaultVerses;
 	VS->Parse(buffer);
+
+	WarheadTypeExt::VersesTable::Invalidate();
 }
 
 void ArmorType::LoadFromStream(AresStreamReader &Stm)
@@ -1,13 +1,17 @@
 #include "Prerequisites.h"
 
 #include "../Ares.h"
+#include "../Ext/Building/Body.h"
+#include "../Ext/House/Body.h"
 #include "../Misc/SavegameDef.h"
 
 #include <ArrayClasses.h>
+#include <BuildingClass.h>
 #include <BuildingTypeClass.h>
 #include <HouseClass.h>
 
 Enumerable<GenericPrerequisite>::container_t Enumerable<GenericPrerequisite>::Array;
+Enumerable<GenericPrerequisite>::index_t Enumerable<GenericPrerequisite>::Index;
 
 const char * Enumerable<GenericPrerequisite>::GetMainSection()
 {
@@ -103,19 +107,135 @@ void Prereqs::ParseAlternate(CCINIClass *pINI, const char *section, const char *
 	}
 }
 
-	// helper funcs
+void OwnedPrerequisites::Rebuild(HouseClass const* const pHouse)
+{
+	this->Upgrades.assign(static_cast<size_t>(BuildingTypeClass::Array->Count), 0);
+	this->Dirty = false;
 
-bool Prereqs::HouseOwnsGeneric(HouseClass const* const pHouse, int const Index)
+	for(auto const& pBld : pHouse->Buildings) {
+		auto const pExt = BuildingExt::ExtMap.Find(pBld);
+		if(auto const pOld = pExt->PrerequisitesOwner) {
+			if(pOld != pHouse) {
+				HouseExt::ExtMap.Find(pOld)->OwnedPrereqs.AddUpgrades(pBld, -1);
+			}
+		}
+		pExt->PrerequisitesOwner = pHouse;
+		this->AddUpgrades(pBld, 1);
+	}
+}
+
+void OwnedPrerequisites::AddUpgrades(
+	BuildingClass const* const pBuilding, int const count)
+{
+	for(auto const& pUpgrade : pBuilding->Upgrades) {
+		if(pUpgrade) {
+			this->AddUpgrade(pBuilding, pUpgrade, count);
+		}
+	}
+}
+
+void OwnedPrerequisites::AddUpgrade(
+	BuildingClass const* const pBuilding,
+	BuildingTypeClass const* const pUpgrade, int const count)
+{
+	// upgrades only count if they are attached to the core they power up
+	auto const idx = static_cast<size_t>(pUpgrade->ArrayIndex);
+	if(idx < this->Upgrades.size()
+		&& !_strcmpi(pUpgrade->PowersUpBuilding, pBuilding->Type->ID))
+	{
+		this->Upgrades[idx] += count;
+	}
+}
+
+bool OwnedPrerequisites::HasSpecific(
+	HouseClass const* const pHouse, int const Index) const
+{
+	auto const pType = BuildingTypeClass::Array->Items[Index];
+	if(*pType->PowersUpBuilding) {
+		auto const idx = static_cast<size_t>(Index);
+		return idx < this->Upgrades.size() && this->Upgrades[idx] > 0;
+	}
+	return pHouse->OwnedBuildingTypes1.GetItemCount(Index) > 0;
+}
+
+bool OwnedPrerequisites::HasGeneric(
+	HouseClass const* const pHouse, int const Index) const
 {
 	// hack - POWER is -1 , this way converts to 0, and onwards
-	auto const idxPrereq = static_cast<unsigned int>(-1 - Index);
-	if(idxPrereq < GenericPrerequisite::Array.size()) {
-		auto const& Prereq = GenericPrerequisite::Array[idxPrereq];
-		for(const auto& index : Prereq->Prereqs) {
-			if(HouseOwnsSpecific(pHouse, index)) {
+	auto const idx = static_cast<size_t>(-1 - Index);
+	if(idx < GenericPrerequisite::Array.size()) {
+		for(auto const& index : GenericPrerequisite::Array[idx]->Prereqs) {
+			if(this->HasSpecific(pHouse, index)) {
 				return true;
 			}
 		}
+	}
+	return false;
+}
+
+	// helper funcs
+
+OwnedPrerequisites const& Prereqs::GetOwned(HouseClass const* const pHouse)
+{
+	auto& owned = HouseExt::ExtMap.Find(pHouse)->OwnedPrereqs;
+	if(owned.IsDirty()) {
+		owned.Rebuild(pHouse);
+	}
+	return owned;
+}
+
+void Prereqs::UpdateBuilding(BuildingClass* const pBuilding, bool const added)
+{
+	auto const pExt = BuildingExt::ExtMap.Find(pBuilding);
+	if(!pExt) {
+		return;
+	}
+
+	auto const pHouse = added ? pBuilding->Owner : nullptr;
+	if(pExt->PrerequisitesOwner == pHouse) {
+		return;
+	}
+
+	if(auto const pOld = pExt->PrerequisitesOwner) {
+		HouseExt::ExtMap.Find(pOld)->OwnedPrereqs.AddUpgrades(pBuilding, -1);
+		pExt->PrerequisitesOwner = nullptr;
+	}
+
+	// a house that has not been rebuilt yet will find it on its own
+	if(pHouse) {
+		auto& owned = HouseExt::ExtMap.Find(pHouse)->OwnedPrereqs;
+		if(!owned.IsDirty()) {
+			owned.AddUpgrades(pBuilding, 1);
+			pExt->PrerequisitesOwner = pHouse;
+		}
+	}
+}
+
+void Prereqs::UpgradeAttached(
+	BuildingClass* const pBuilding, BuildingTypeClass* const pUpgrade)
+{
+	// the upgrade is part of the building already. if the building is not
+	// counted yet, this counts it together with all its upgrades
+	auto const pExt = BuildingExt::ExtMap.Find(pBuilding);
+	if(auto const pHouse = pExt->PrerequisitesOwner) {
+		HouseExt::ExtMap.Find(pHouse)->OwnedPrereqs.AddUpgrade(pBuilding, pUpgrade, 1);
+	} else {
+		UpdateBuilding(pBuilding, true);
+	}
+}
+
+bool Prereqs::HouseOwnsGeneric(
+	HouseClass const* const pHouse, OwnedPrerequisites const& owned,
+	int const Index)
+{
+	if(owned.HasGeneric(pHouse, Index)) {
+		return true;
+	}
+
+	// alternates can be any techno, so they are not part of the cache
+	auto const idxPrereq = static_cast<unsigned int>(-1 - Index);
+	if(idxPrereq < GenericPrerequisite::Array.size()) {
+		auto const& Prereq = GenericPrerequisite::Array[idxPrereq];
 		for(const auto& pType : Prereq->Alternates) {
 			if(pHouse->CountOwnedNow(pType)) {
 				return true;
@@ -125,43 +245,36 @@ bool Prereqs::HouseOwnsGeneric(HouseClass const* const pHouse, int const Index)
 	return false;
 }
 
+bool Prereqs::HouseOwnsPrereq(
+	HouseClass const* const pHouse, OwnedPrerequisites const& owned,
+	int const Index)
+{
+	return Index < 0
+		? HouseOwnsGeneric(pHouse, owned, Index)
+		: owned.HasSpecific(pHouse, Index)
+	;
+}
+
+bool Prereqs::HouseOwnsGeneric(HouseClass const* const pHouse, int const Index)
+{
+	return HouseOwnsGeneric(pHouse, GetOwned(pHouse), Index);
+}
+
 bool Prereqs::HouseOwnsSpecific(HouseClass const* const pHouse, int const Index)
 {
-	auto const pType = BuildingTypeClass::Array->Items[Index];
-	auto const pPowerup = pType->PowersUpBuilding;
-	if(*pPowerup) {
-		auto const pCore = BuildingTypeClass::Find(pPowerup);
-		if(!pCore || pHouse->OwnedBuildingTypes1.GetItemCount(pCore->ArrayIndex) < 1) {
-			return false;
-		}
-		for(auto const& pBld : pHouse->Buildings) {
-			if(pBld->Type != pCore) {
-				continue;
-			}
-			for(const auto& pUpgrade : pBld->Upgrades) {
-				if(pUpgrade == pType) {
-					return true;
-				}
-			}
-		}
-		return false;
-	} else {
-		return pHouse->OwnedBuildingTypes1.GetItemCount(Index) > 0;
-	}
+	return GetOwned(pHouse).HasSpecific(pHouse, Index);
 }
 
 bool Prereqs::HouseOwnsPrereq(HouseClass const* const pHouse, int const Index)
 {
-	return Index < 0
-		? HouseOwnsGeneric(pHouse, Index)
-		: HouseOwnsSpecific(pHouse, Index)
-	;
+	return HouseOwnsPrereq(pHouse, GetOwned(pHouse), Index);
 }
 
 bool Prereqs::HouseOwnsAll(HouseClass const* const pHouse, const DynamicVectorClass<int> &list)
 {
+	auto const& owned = GetOwned(pHouse);
 	for(const auto& index : list) {
-		if(!HouseOwnsPrereq(pHouse, index)) {
+		if(!HouseOwnsPrereq(pHouse, owned, index)) {
 			return false;
 		}
 	}
@@ -170,8 +283,9 @@ bool Prereqs::HouseOwnsAll(HouseClass const* const pHouse, const DynamicVectorCl
 
 bool Prereqs::HouseOwnsAny(HouseClass const* const pHouse, const DynamicVectorClass<int> &list)
 {
+	auto const& owned = GetOwned(pHouse);
 	for(const auto& index : list) {
-		if(HouseOwnsPrereq(pHouse, index)) {
+		if(HouseOwnsPrereq(pHouse, owned, index)) {
 			return true;
 		}
 	}
@@ -4,6 +4,9 @@
 
 #include "../Utilities/Iterator.h"
 
+#include <vector>
+
+class BuildingClass;
 class BuildingTypeClass;
 class CCINIClass;
 class HouseClass;
@@ -28,6 +31,35 @@ public:
 	DynamicVectorClass<TechnoTypeClass*> Alternates;
 };
 
+// the upgrades a house has attached to the buildings they power up, counted
+// per building type. plain buildings are counted by the game itself, and
+// generic prerequisites are resolved from both when asked. alternates can be
+// any techno, so they are checked separately. kept up to date by the building
+// hooks, see Prereqs::UpdateBuilding. not saved, rebuilt after loading.
+class OwnedPrerequisites
+{
+public:
+	OwnedPrerequisites() : Upgrades(), Dirty(true)
+	{ }
+
+	bool IsDirty() const {
+		return this->Dirty;
+	}
+
+	void Rebuild(HouseClass const* pHouse);
+
+	// adds count to all upgrades of pBuilding that power it up
+	void AddUpgrades(BuildingClass const* pBuilding, int count);
+	void AddUpgrade(BuildingClass const* pBuilding, BuildingTypeClass const* pUpgrade, int count);
+
+	bool HasSpecific(HouseClass const* pHouse, int Index) const;
+	bool HasGeneric(HouseClass const* pHouse, int Index) const;
+
+private:
+	std::vector<int> Upgrades;
+	bool Dirty;
+};
+
 class Prereqs
 {
 public:
@@ -36,6 +68,15 @@ public:
 	static void Parse(CCINIClass *pINI, const char* section, const char *key, DynamicVectorClass<int> &Vec);
 	static void ParseAlternate(CCINIClass *pINI, const char* section, const char *key, DynamicVectorClass<TechnoTypeClass*> &Vec);
 
+	static OwnedPrerequisites const& GetOwned(HouseClass const* pHouse);
+
+	// a building was added to its owner, or removed from the house it was
+	// counted for
+	static void UpdateBuilding(BuildingClass* pBuilding, bool added);
+
+	// an upgrade has been attached to pBuilding
+	static void UpgradeAttached(BuildingClass* pBuilding, BuildingTypeClass* pUpgrade);
+
 	static bool HouseOwnsGeneric(HouseClass const* pHouse, int Index);
 	static bool HouseOwnsSpecific(HouseClass const* pHouse, int Index);
 	static bool HouseOwnsPrereq(HouseClass const* pHouse, int Index);
@@ -43,6 +84,9 @@ public:
 	static bool HouseOwnsAll(HouseClass const* pHouse, const DynamicVectorClass<int> &list);
 	static bool HouseOwnsAny(HouseClass const* pHouse, const DynamicVectorClass<int> &list);
 
+	static bool HouseOwnsGeneric(HouseClass const* pHouse, OwnedPrerequisites const& owned, int Index);
+	static bool HouseOwnsPrereq(HouseClass const* pHouse, OwnedPrerequisites const& owned, int Index);
+
 	static bool ListContainsGeneric(const BTypeIter &List, int Index);
 	static bool ListContainsSpecific(const BTypeIter &List, int Index);
 	static bool ListContainsPrereq(const BTypeIter &List, int Index);
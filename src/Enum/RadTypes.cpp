@@ -5,6 +5,7 @@
 #include <WarheadTypeClass.h>
 
 Enumerable<RadType>::container_t Enumerable<RadType>::Array;
+Enumerable<RadType>::index_t Enumerable<RadType>::Index;
 
 // pretty nice, eh
 const char * Enumerable<RadType>::GetMainSection()
@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include <ArrayClasses.h>
@@ -14,18 +15,21 @@
 template <typename T> class Enumerable
 {
 	typedef std::vector<std::unique_ptr<T>> container_t;
+	typedef std::unordered_map<const char*, size_t, AresCRT::StrHashI, AresCRT::StrEqualI> index_t;
 public:
 	static container_t Array;
 
+	// maps the names of the items in Array to their positions, ignoring case.
+	// keys point to the items' own names. kept in sync by FindOrAllocate and Clear
+	static index_t Index;
+
 	static int FindIndex(const char *Title)
 	{
-		auto result = std::find_if(Array.begin(), Array.end(), [Title](std::unique_ptr<T> &Item) {
-			return !_strcmpi(Item->Name, Title);
-		});
-		if(result == Array.end()) {
+		auto result = Index.find(Title);
+		if(result == Index.end()) {
 			return -1;
 		}
-		return std::distance(Array.begin(), result);
+		return static_cast<int>(result->second);
 	}
 
 	static T* Find(const char *Title)
@@ -40,11 +44,14 @@ public:
 			return find;
 		}
 		Array.push_back(std::make_unique<T>(Title));
-		return Array.back().get();
+		auto const pItem = Array.back().get();
+		Index.emplace(pItem->Name, Array.size() - 1);
+		return pItem;
 	}
 
 	static void Clear()
 	{
+		Index.clear();
 		Array.clear();
 	}
 
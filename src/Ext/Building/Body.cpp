@@ -1135,6 +1135,7 @@ void BuildingExt::ExtData::Serialize(T& Stm) {
 void BuildingExt::ExtData::LoadFromStream(AresStreamReader &Stm) {
 	Extension<BuildingClass>::LoadFromStream(Stm);
 	this->Serialize(Stm);
+	cPrismForwarding::InvalidateTowers();
 }
 
 void BuildingExt::ExtData::SaveToStream(AresStreamWriter &Stm) {
@@ -1176,7 +1177,9 @@ DEFINE_HOOK(43BCBD, BuildingClass_CTOR, 6)
 {
 	GET(BuildingClass*, pItem, ESI);
 
-	BuildingExt::ExtMap.FindOrAllocate(pItem);
+	if(auto const pData = BuildingExt::ExtMap.FindOrAllocate(pItem)) {
+		BuildingExt::cPrismForwarding::RegisterBuilding(&pData->PrismForwarding);
+	}
 	return 0;
 }
 
@@ -1184,6 +1187,10 @@ DEFINE_HOOK(43C022, BuildingClass_DTOR, 6)
 {
 	GET(BuildingClass*, pItem, ESI);
 
+	if(auto const pData = BuildingExt::ExtMap.Find(pItem)) {
+		BuildingExt::cPrismForwarding::UnregisterBuilding(&pData->PrismForwarding);
+	}
+	Prereqs::UpdateBuilding(pItem, false);
 	BuildingExt::ExtMap.Remove(pItem);
 	return 0;
 }
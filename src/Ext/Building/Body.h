@@ -11,6 +11,8 @@
 #include "../../Misc/Debug.h"
 #endif
 
+#include <vector>
+
 class SuperClass;
 
 class BuildingExt
@@ -46,9 +48,19 @@ public:
 			return this->Owner->OwnerObject();
 		}
 
-		int AcquireSlaves_MultiStage(cPrismForwarding* TargetTower, int stage, int chain, int& NetworkSize, int& LongestChain);
-		int AcquireSlaves_SingleStage(cPrismForwarding* TargetTower, int stage, int chain, int& NetworkSize, int& LongestChain);
-		bool ValidateSupportTower(cPrismForwarding* TargetTower, cPrismForwarding* SlaveTower);
+		// what a volley needs to know about a tower that could support others
+		struct SupportCandidate {
+			cPrismForwarding* Tower;
+			CoordStruct Position;
+			int MinimumRange;
+			int SupportRange;
+		};
+
+		// enslaves the towers supporting this one and returns the longest chain
+		int AcquireSlaves();
+		int AcquireSlaves_SingleStage(cPrismForwarding* TargetTower, int chain, int& NetworkSize, int& LongestChain, std::vector<SupportCandidate> const& Candidates);
+		bool GetSupportCandidate(cPrismForwarding* SlaveTower, SupportCandidate& Candidate) const;
+		bool ValidateSupportTower(cPrismForwarding* TargetTower, SupportCandidate const& Candidate) const;
 		void SetChargeDelay(int LongestChain);
 		void SetChargeDelay_Get(int chain, int endChain, int LongestChain, DWORD* LongestCDelay, DWORD* LongestFDelay);
 		void SetChargeDelay_Set(int chain, DWORD const* LongestCDelay, DWORD const* LongestFDelay, int LongestChain);
@@ -59,6 +71,23 @@ public:
 		bool Load(AresStreamReader &Stm, bool RegisterForChange);
 
 		bool Save(AresStreamWriter &Stm) const;
+
+		// all towers that can forward, in BuildingClass::Array order. new
+		// buildings are added on the next volley, when their type is known.
+		static std::vector<cPrismForwarding*> const& GetTowers();
+		static void RegisterBuilding(cPrismForwarding* pTower);
+		static void UnregisterBuilding(cPrismForwarding* pTower);
+		static void InvalidateTowers();
+
+		// writes every network that is charging to the log
+		static void LogNetworks();
+
+	private:
+		void LogNetwork(int depth) const;
+
+		static std::vector<cPrismForwarding*> Towers;
+		static std::vector<cPrismForwarding*> NewBuildings;
+		static bool TowersValid;
 	};
 
 
@@ -89,6 +118,8 @@ public:
 
 		VectorClass<int> DockReloadTimers;
 
+		HouseClass const* PrerequisitesOwner; //!< The house whose owned prerequisites count the upgrades of this building. Not saved. \sa OwnedPrerequisites
+
 	public:
 		ExtData(BuildingClass* OwnerObject) : Extension<BuildingClass>(OwnerObject),
 			OwnerBeforeRaid(nullptr),
@@ -99,7 +130,8 @@ public:
 			AboutToChronoshift(false),
 			SecretLab_Placed(false),
 			TogglePower_HasPower(true),
-			SensorArrayActiveCounter(0)
+			SensorArrayActiveCounter(0),
+			PrerequisitesOwner(nullptr)
 		{ }
 
 		virtual ~ExtData() = default;
@@ -39,14 +39,8 @@ DEFINE_HOOK(44B2FE, BuildingClass_Mi_Attack_IsPrism, 6)
 			pMasterData->PrismForwarding.ModifierReserve = 0.0;
 			pMasterData->PrismForwarding.DamageReserve = 0;
 
-			int LongestChain = 0;
-
 			//set up slaves
-			int NetworkSize = 0;
-			int stage = 0;
-
-			//when it reaches zero we can't acquire any more slaves
-			while(pMasterData->PrismForwarding.AcquireSlaves_MultiStage(&pMasterData->PrismForwarding, stage++, 0, NetworkSize, LongestChain) != 0) {}
+			auto const LongestChain = pMasterData->PrismForwarding.AcquireSlaves();
 
 			//now we have all the towers we know the longest chain, and can set all the towers' charge delays
 			pMasterData->PrismForwarding.SetChargeDelay(LongestChain);
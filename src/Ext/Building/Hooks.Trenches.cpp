@@ -195,6 +195,7 @@ DEFINE_HOOK(52297F, InfantryClass_GarrisonBuilding_OccupierEntered, 5)
 	TechnoExt::ExtData* infExtData = TechnoExt::ExtMap.Find(pInf);
 
 	infExtData->GarrisonedIn = pBld;
+	TechnoExt::ExtMap.Watch(infExtData, pBld);
 
 	// if building and owner are from different players, and the building is not in raided state
 	// change the building's owner and mark it as raided
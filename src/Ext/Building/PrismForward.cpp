@@ -4,10 +4,15 @@
 #include "../../Misc/SavegameDef.h"
 
 #include <HouseClass.h>
+#include <HouseTypeClass.h>
 
 #include <vector>
 #include <algorithm>
 
+std::vector<BuildingExt::cPrismForwarding*> BuildingExt::cPrismForwarding::Towers;
+std::vector<BuildingExt::cPrismForwarding*> BuildingExt::cPrismForwarding::NewBuildings;
+bool BuildingExt::cPrismForwarding::TowersValid = false;
+
 bool BuildingExt::cPrismForwarding::Load(AresStreamReader &Stm, bool RegisterForChange) {
 	// support pointer to this type
 	Stm.RegisterChange(this);
@@ -34,8 +39,8 @@ bool BuildingExt::cPrismForwarding::Save(AresStreamWriter &Stm) const {
 		.Success();
 }
 
-int BuildingExt::cPrismForwarding::AcquireSlaves_MultiStage(BuildingExt::cPrismForwarding* const TargetTower, int const stage, int const chain, int& NetworkSize, int& LongestChain) {
-	//get all slaves for a specific stage in the prism chain
+int BuildingExt::cPrismForwarding::AcquireSlaves() {
+	//get all slaves for the prism chain, one stage after the other
 	//this is done for all sibling chains in parallel, so we prefer multiple short chains over one really long chain
 	//towers should be added in the following way:
 	// 1---2---4---6
@@ -50,20 +55,50 @@ int BuildingExt::cPrismForwarding::AcquireSlaves_MultiStage(BuildingExt::cPrismF
 	// |
 	// 6---7--8
 	// ...which would not be as good.
-	auto countSlaves = 0;
-	if(stage == 0) {
-		countSlaves += this->AcquireSlaves_SingleStage(TargetTower, stage, chain + 1, NetworkSize, LongestChain);
-	} else {
-		// do not think of using iterators or a ranged-for here. Senders grows and might reallocate.
-		for(auto senderIdx = 0; senderIdx < TargetTower->Senders.Count; ++senderIdx) {
-			auto const& SenderTower = TargetTower->Senders[senderIdx];
-			countSlaves += this->AcquireSlaves_MultiStage(SenderTower, stage - 1, chain + 1, NetworkSize, LongestChain);
+
+	// everything about the supporting towers that does not depend on the
+	// tower they support is checked once per volley
+	auto const& Towers = GetTowers();
+	std::vector<SupportCandidate> Candidates;
+	Candidates.reserve(Towers.size());
+	for(auto const& pTower : Towers) {
+		SupportCandidate Candidate;
+		if(this->GetSupportCandidate(pTower, Candidate)) {
+			Candidates.push_back(Candidate);
+		}
+	}
+
+	auto NetworkSize = 0;
+	auto LongestChain = 0;
+
+	// breadth first: the towers of one stage support the towers acquired
+	// in the stage before. the network stops growing as soon as a stage
+	// does not acquire a single slave.
+	std::vector<cPrismForwarding*> Stage(1, this);
+	std::vector<cPrismForwarding*> NextStage;
+	for(auto chain = 1; !Stage.empty() && !Candidates.empty(); ++chain) {
+		auto countSlaves = 0;
+		for(auto const& TargetTower : Stage) {
+			countSlaves += this->AcquireSlaves_SingleStage(TargetTower, chain, NetworkSize, LongestChain, Candidates);
+		}
+
+		if(!countSlaves) {
+			break;
 		}
+
+		NextStage.clear();
+		for(auto const& TargetTower : Stage) {
+			for(auto const& SenderTower : TargetTower->Senders) {
+				NextStage.push_back(SenderTower);
+			}
+		}
+		Stage.swap(NextStage);
 	}
-	return countSlaves;
+
+	return LongestChain;
 }
 
-int BuildingExt::cPrismForwarding::AcquireSlaves_SingleStage(BuildingExt::cPrismForwarding* const TargetTower, int const stage, int const chain, int& NetworkSize, int& LongestChain) {
+int BuildingExt::cPrismForwarding::AcquireSlaves_SingleStage(BuildingExt::cPrismForwarding* const TargetTower, int const chain, int& NetworkSize, int& LongestChain, std::vector<SupportCandidate> const& Candidates) {
 	//set up immediate slaves for this particular tower
 
 	auto const pMasterType = this->GetOwner()->Type;
@@ -90,17 +125,15 @@ int BuildingExt::cPrismForwarding::AcquireSlaves_SingleStage(BuildingExt::cPrism
 		}
 	};
 
-	CoordStruct MyPosition, curPosition;
+	CoordStruct MyPosition;
 	TargetTower->GetOwner()->GetPosition_2(&MyPosition);
 
 	//first, find eligible towers
 	std::vector<PrismTargetData> EligibleTowers;
-	for(auto const& SlaveTower : *BuildingClass::Array) {
-		auto const pSlaveData = BuildingExt::ExtMap.Find(SlaveTower);
-		if(this->ValidateSupportTower(TargetTower, &pSlaveData->PrismForwarding)) {
-			SlaveTower->GetPosition_2(&curPosition);
-			int Distance = static_cast<int>(MyPosition.DistanceFrom(curPosition));
-			PrismTargetData pd = {&pSlaveData->PrismForwarding, Distance};
+	for(auto const& Candidate : Candidates) {
+		if(this->ValidateSupportTower(TargetTower, Candidate)) {
+			int Distance = static_cast<int>(MyPosition.DistanceFrom(Candidate.Position));
+			PrismTargetData pd = {Candidate.Tower, Distance};
 			EligibleTowers.push_back(pd);
 		}
 	}
@@ -140,79 +173,113 @@ int BuildingExt::cPrismForwarding::AcquireSlaves_SingleStage(BuildingExt::cPrism
 	return iFeeds;
 }
 
-bool BuildingExt::cPrismForwarding::ValidateSupportTower(BuildingExt::cPrismForwarding* const pTargetTower, BuildingExt::cPrismForwarding* const pSlaveTower) {
+bool BuildingExt::cPrismForwarding::GetSupportCandidate(BuildingExt::cPrismForwarding* const pSlaveTower, SupportCandidate& Candidate) const {
+	//MasterTower = the firing tower
+	//SlaveTower = the tower being considered to support any tower of the network
+	//acquiring slaves does not change any of the things checked here
+	auto const SlaveTower = pSlaveTower->GetOwner();
+	if(!SlaveTower->IsAlive) {
+		return false;
+	}
+
+	auto const pSlaveType = SlaveTower->Type;
+	auto const pSlaveTypeData = BuildingTypeExt::ExtMap.Find(pSlaveType);
+	if(!pSlaveTypeData->PrismForwarding.CanForward()) {
+		return false;
+	}
+
+	//building is a prism tower
+	//get all the data we need
+	auto const pTechnoData = TechnoExt::ExtMap.Find(SlaveTower);
+	auto const SlaveMission = SlaveTower->GetCurrentMission();
+	//now check all the rules
+	if(!SlaveTower->ReloadTimer.Expired()
+		|| SlaveTower->IsBeingDrained()
+		|| SlaveTower->IsBeingWarpedOut()
+		|| SlaveMission == Mission::Attack
+		|| SlaveMission == Mission::Construction
+		|| SlaveMission == Mission::Selling
+		|| !pTechnoData->IsPowered() //robot control logic
+		|| !pTechnoData->IsOperated() //operator logic
+		|| !SlaveTower->IsPowerOnline() //base-powered or overpowerer-powered
+		|| SlaveTower->IsUnderEMP()) //EMP logic - I think this should already be checked by IsPowerOnline() but included just to be sure
+	{
+		return false;
+	}
+
+	//the master has to be owned or allied in any case
+	auto const pMasterHouse = this->GetOwner()->Owner;
+	auto const pSlaveHouse = SlaveTower->Owner;
+	if(pSlaveHouse != pMasterHouse
+		&& !(pSlaveTypeData->PrismForwarding.ToAllies && pSlaveHouse->IsAlliedWith(pMasterHouse)))
+	{
+		return false;
+	}
+
+	Candidate.Tower = pSlaveTower;
+	SlaveTower->GetPosition_2(&Candidate.Position);
+	Candidate.MinimumRange = 0;
+	Candidate.SupportRange = 0;
+
+	int idxSupport = -1;
+	if(SlaveTower->Veterancy.IsElite()) {
+		idxSupport = pSlaveTypeData->PrismForwarding.EliteSupportWeaponIndex;
+	} else {
+		idxSupport = pSlaveTypeData->PrismForwarding.SupportWeaponIndex;
+	}
+	if(idxSupport != -1) {
+		if(auto const supportWeapon = pSlaveType->Weapon[idxSupport].WeaponType) {
+			Candidate.MinimumRange = supportWeapon->MinimumRange;
+			Candidate.SupportRange = supportWeapon->Range;
+		}
+	}
+	if(Candidate.SupportRange == 0) {
+		//not specified on SupportWeapon so use Primary + 1 cell (Marshall chose to add the +1 cell default - see manual for reason)
+		if(auto const cPrimary = pSlaveType->Weapon[0].WeaponType) {
+			Candidate.SupportRange = cPrimary->Range + 256; //256 leptons == 1 cell
+		}
+	}
+
+	return true;
+}
+
+bool BuildingExt::cPrismForwarding::ValidateSupportTower(BuildingExt::cPrismForwarding* const pTargetTower, SupportCandidate const& Candidate) const {
 	//MasterTower = the firing tower. This might be the same as TargetTower, it might not.
 	//TargetTower = the tower that we are forwarding to
 	//SlaveTower = the tower being considered to support TargetTower
+	//whatever the candidate does not depend on has been checked when it was collected
 	auto const TargetTower = pTargetTower->GetOwner();
-	auto const SlaveTower = pSlaveTower->GetOwner();
-	if(SlaveTower->IsAlive) {
-		auto const pSlaveType = SlaveTower->Type;
-		auto const pSlaveTypeData = BuildingTypeExt::ExtMap.Find(pSlaveType);
-		if(pSlaveTypeData->PrismForwarding.CanForward())
-		{
-			//building is a prism tower
-			//get all the data we need
-			auto const pTechnoData = TechnoExt::ExtMap.Find(SlaveTower);
-			//BuildingExt::ExtData *pSlaveData = BuildingExt::ExtMap.Find(SlaveTower);
-			auto const SlaveMission = SlaveTower->GetCurrentMission();
-			//now check all the rules
-			if(SlaveTower->ReloadTimer.Expired()
-				&& SlaveTower != TargetTower
-				&& !SlaveTower->DelayBeforeFiring
-				&& !SlaveTower->IsBeingDrained()
-				&& !SlaveTower->IsBeingWarpedOut()
-				&& SlaveMission != Mission::Attack
-				&& SlaveMission != Mission::Construction
-				&& SlaveMission != Mission::Selling
-				&& pTechnoData->IsPowered() //robot control logic
-				&& pTechnoData->IsOperated() //operator logic
-				&& SlaveTower->IsPowerOnline() //base-powered or overpowerer-powered
-				&& !SlaveTower->IsUnderEMP()) //EMP logic - I think this should already be checked by IsPowerOnline() but included just to be sure
-			{
-				auto const pTargetType = TargetTower->Type;
-				if(pSlaveTypeData->PrismForwarding.Targets.Contains(pTargetType)) {
-					//valid type to forward from
-					const auto pMasterHouse = this->GetOwner()->Owner;
-					const auto pTargetHouse = TargetTower->Owner;
-					const auto pSlaveHouse = SlaveTower->Owner;
-					if((pSlaveHouse == pTargetHouse && pSlaveHouse == pMasterHouse)
-						|| (pSlaveTypeData->PrismForwarding.ToAllies
-						&& pSlaveHouse->IsAlliedWith(pTargetHouse)
-						&& pSlaveHouse->IsAlliedWith(pMasterHouse)))
-					{
-						//ownership/alliance rules satisfied
-						CoordStruct MyPosition, curPosition;
-						TargetTower->GetPosition_2(&MyPosition);
-						SlaveTower->GetPosition_2(&curPosition);
-						auto const Distance = static_cast<int>(MyPosition.DistanceFrom(curPosition));
-						int SupportRange = 0;
-						int idxSupport = -1;
-						if(SlaveTower->Veterancy.IsElite()) {
-							idxSupport = pSlaveTypeData->PrismForwarding.EliteSupportWeaponIndex;
-						} else {
-							idxSupport = pSlaveTypeData->PrismForwarding.SupportWeaponIndex;
-						}
-						if(idxSupport != -1) {
-							if(auto const supportWeapon = pSlaveType->Weapon[idxSupport].WeaponType) {
-								if(Distance < supportWeapon->MinimumRange) {
-									return false; //below minimum range
-								}
-								SupportRange = supportWeapon->Range;
-							}
-						}
-						if(SupportRange == 0) {
-							//not specified on SupportWeapon so use Primary + 1 cell (Marshall chose to add the +1 cell default - see manual for reason)
-							if(auto const cPrimary = pSlaveType->Weapon[0].WeaponType) {
-								SupportRange = cPrimary->Range + 256; //256 leptons == 1 cell
-							}
-						}
-						if(SupportRange < 0 || Distance <= SupportRange) {
-							return true; //within range
-						}
-					}
-				}
-			}
+	auto const SlaveTower = Candidate.Tower->GetOwner();
+
+	//towers acquired earlier in this volley are delayed
+	if(SlaveTower == TargetTower || SlaveTower->DelayBeforeFiring) {
+		return false;
+	}
+
+	auto const pSlaveTypeData = BuildingTypeExt::ExtMap.Find(SlaveTower->Type);
+	auto const pTargetType = TargetTower->Type;
+	if(!pSlaveTypeData->PrismForwarding.Targets.Contains(pTargetType)) {
+		return false;
+	}
+
+	//valid type to forward from
+	const auto pMasterHouse = this->GetOwner()->Owner;
+	const auto pTargetHouse = TargetTower->Owner;
+	const auto pSlaveHouse = SlaveTower->Owner;
+	if((pSlaveHouse == pTargetHouse && pSlaveHouse == pMasterHouse)
+		|| (pSlaveTypeData->PrismForwarding.ToAllies
+		&& pSlaveHouse->IsAlliedWith(pTargetHouse)
+		&& pSlaveHouse->IsAlliedWith(pMasterHouse)))
+	{
+		//ownership/alliance rules satisfied
+		CoordStruct MyPosition;
+		TargetTower->GetPosition_2(&MyPosition);
+		auto const Distance = static_cast<int>(MyPosition.DistanceFrom(Candidate.Position));
+		if(Distance < Candidate.MinimumRange) {
+			return false; //below minimum range
+		}
+		if(Candidate.SupportRange < 0 || Distance <= Candidate.SupportRange) {
+			return true; //within range
 		}
 	}
 	return false;
@@ -344,3 +411,78 @@ void BuildingExt::cPrismForwarding::RemoveAllSenders() {
 		this->Senders.Clear();
 	}
 }
+
+std::vector<BuildingExt::cPrismForwarding*> const& BuildingExt::cPrismForwarding::GetTowers() {
+	auto const CanForward = [](cPrismForwarding* const pTower) {
+		auto const pTypeData = BuildingTypeExt::ExtMap.Find(pTower->GetOwner()->Type);
+		return pTypeData && pTypeData->PrismForwarding.CanForward();
+	};
+
+	if(!TowersValid) {
+		Towers.clear();
+		NewBuildings.clear();
+		for(auto const& pBld : *BuildingClass::Array) {
+			if(auto const pData = BuildingExt::ExtMap.Find(pBld)) {
+				if(CanForward(&pData->PrismForwarding)) {
+					Towers.push_back(&pData->PrismForwarding);
+				}
+			}
+		}
+		TowersValid = true;
+	} else if(!NewBuildings.empty()) {
+		// buildings are appended to BuildingClass::Array in the same order
+		for(auto const& pTower : NewBuildings) {
+			if(CanForward(pTower)) {
+				Towers.push_back(pTower);
+			}
+		}
+		NewBuildings.clear();
+	}
+
+	return Towers;
+}
+
+void BuildingExt::cPrismForwarding::RegisterBuilding(BuildingExt::cPrismForwarding* const pTower) {
+	if(TowersValid) {
+		NewBuildings.push_back(pTower);
+	}
+}
+
+void BuildingExt::cPrismForwarding::UnregisterBuilding(BuildingExt::cPrismForwarding* const pTower) {
+	Towers.erase(std::remove(Towers.begin(), Towers.end(), pTower), Towers.end());
+	NewBuildings.erase(std::remove(NewBuildings.begin(), NewBuildings.end(), pTower), NewBuildings.end());
+}
+
+void BuildingExt::cPrismForwarding::InvalidateTowers() {
+	TowersValid = false;
+	Towers.clear();
+	NewBuildings.clear();
+}
+
+void BuildingExt::cPrismForwarding::LogNetworks() {
+	auto count = 0;
+
+	// the firing tower might not be able to forward itself, so look at all
+	for(auto const& pBld : *BuildingClass::Array) {
+		auto const pData = BuildingExt::ExtMap.Find(pBld);
+		if(pData && !pData->PrismForwarding.SupportTarget && pData->PrismForwarding.Senders.Count) {
+			pData->PrismForwarding.LogNetwork(0);
+			++count;
+		}
+	}
+
+	Debug::Log("%d prism networks charging, %u towers can forward.\n",
+		count, GetTowers().size());
+}
+
+void BuildingExt::cPrismForwarding::LogNetwork(int const depth) const {
+	auto const pBld = this->GetOwner();
+	Debug::Log("%*s%s (%p) of %s: stage %d, charge delay %d, fire delay %d, %d senders\n",
+		depth * 2, "", pBld->Type->ID, pBld, pBld->Owner->Type->ID,
+		static_cast<int>(pBld->PrismStage), this->PrismChargeDelay,
+		pBld->DelayBeforeFiring, this->Senders.Count);
+
+	for(auto const& pSender : this->Senders) {
+		pSender->LogNetwork(depth + 1);
+	}
+}
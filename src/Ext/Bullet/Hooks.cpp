@@ -9,8 +9,11 @@
 #include "../WeaponType/Body.h"
 #include <ScenarioClass.h>
 #include <YRMath.h>
+
+#include <algorithm>
 #include <Helpers/Iterators.h>
 
+#include "../../Misc/TechnoGrid.h"
 #include "../../Misc/TrajectoryHelper.h"
 
 DEFINE_HOOK(468BE2, BulletClass_ShouldDetonate_Obstacle, 6)
@@ -157,7 +160,7 @@ DEFINE_HOOK(469EBA, BulletClass_DetonateAt_Splits, 6)
 
 		} else {
 			// fill with technos in range
-			for(auto pTechno : *TechnoClass::Array) {
+			TechnoGrid::Instance.ForEachInRadius(crdDest, 0x500, [&](TechnoClass* pTechno) {
 				if(pTechno->IsInPlayfield && pTechno->IsOnMap && pTechno->Health > 0) {
 					CoordStruct crdTechno = pTechno->GetCoords();
 
@@ -165,7 +168,14 @@ DEFINE_HOOK(469EBA, BulletClass_DetonateAt_Splits, 6)
 						targets.AddItem(pTechno);
 					}
 				}
-			}
+				return true;
+			});
+
+			// the grid does not return the technos in a fixed order, but the
+			// random selection below has to pick the same ones on all clients
+			std::sort(targets.begin(), targets.end(), [](AbstractClass* pLeft, AbstractClass* pRight) {
+				return pLeft->UniqueID < pRight->UniqueID;
+			});
 
 			// fill up the list to cluster count with random cells around destination
 			const int range = 3;
@@ -9,6 +9,7 @@
 #include "../../Enum/Prerequisites.h"
 #include "../Techno/Body.h"
 #include "../../Misc/SWTypes.h"
+#include "../../Misc/TechnoCounters.h"
 #include "../../Utilities/INIParser.h"
 
 #include <FactoryClass.h>
@@ -168,7 +169,6 @@ signed int HouseExt::BuildLimitRemaining(
 int HouseExt::CountOwnedNowTotal(
 	HouseClass const* const pHouse, TechnoTypeClass const* const pItem)
 {
-	int index = -1;
 	int sum = 0;
 	const BuildingTypeClass* pBType = nullptr;
 	const UnitTypeClass* pUType = nullptr;
@@ -211,14 +211,7 @@ int HouseExt::CountOwnedNowTotal(
 		pIType = static_cast<InfantryTypeClass const*>(pItem);
 		sum = pHouse->CountOwnedNow(pIType);
 		if(pIType->VehicleThief) {
-			index = pIType->ArrayIndex;
-			for(auto const& pUnit : *UnitClass::Array) {
-				if(pUnit->HijackerInfantryType == index
-					&& pUnit->Owner == pHouse)
-				{
-					++sum;
-				}
-			}
+			sum += TechnoCounters::CountHijackedBy(pHouse, pIType);
 		}
 		break;
 
@@ -66,6 +66,15 @@ public:
 
 		std::vector<BuildingClass*> Academies;
 
+		// not saved, rebuilt on demand
+		OwnedPrerequisites OwnedPrereqs;
+
+		// the buildings that provide super weapons through their type or
+		// their upgrades. not saved, rebuilt on demand.
+		std::vector<BuildingClass*> SWProviders;
+		bool SWProvidersDirty;
+		int SWProvidersBuildingCount;
+
 		ExtData(HouseClass* OwnerObject) : Extension<HouseClass>(OwnerObject),
 			IonSensitive(false),
 			FirewallActive(false),
@@ -75,6 +84,8 @@ public:
 			Factory_NavyType(nullptr),
 			Factory_AircraftType(nullptr),
 			SWLastIndex(-1),
+			SWProvidersDirty(true),
+			SWProvidersBuildingCount(-1),
 			RadarPersist(),
 			StolenTech(0ull)
 		{ }
@@ -89,6 +100,10 @@ public:
 			AnnounceInvalidPointer(Factory_VehicleType, ptr);
 			AnnounceInvalidPointer(Factory_NavyType, ptr);
 			AnnounceInvalidPointer(Factory_InfantryType, ptr);
+
+			// only buildings get here. upgrades are buildings, too, which
+			// are removed when they get attached to their core.
+			this->SWProvidersDirty = true;
 		}
 
 		virtual void LoadFromStream(AresStreamReader &Stm) override;
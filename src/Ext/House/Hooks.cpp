@@ -522,3 +522,52 @@ DEFINE_HOOK(4F8440, HouseClass_Update_TogglePower, 5)
 
 	return 0;
 }
+
+// a house gaining or losing a building changes the prerequisites it owns
+// and the buildings that might provide super weapons
+
+namespace {
+	void UpdateOwnedBuilding(BuildingClass* const pBuilding, bool const added) {
+		Prereqs::UpdateBuilding(pBuilding, added);
+
+		if(auto const pExt = HouseExt::ExtMap.Find(pBuilding->Owner)) {
+			pExt->SWProvidersDirty = true;
+		}
+	}
+}
+
+DEFINE_HOOK(446366, BuildingClass_Place_OwnedBuildings, 6)
+{
+	GET(BuildingClass*, pThis, EBP);
+	UpdateOwnedBuilding(pThis, true);
+	return 0;
+}
+
+DEFINE_HOOK(4491D5, BuildingClass_ChangeOwnership_Add_OwnedBuildings, 6)
+{
+	GET(BuildingClass*, pThis, ESI);
+	UpdateOwnedBuilding(pThis, true);
+	return 0;
+}
+
+DEFINE_HOOK_AGAIN(448AB2, BuildingClass_Remove_OwnedBuildings, 6) // ChangeOwnership, old owner
+DEFINE_HOOK(445905, BuildingClass_Remove_OwnedBuildings, 6)
+{
+	GET(BuildingClass*, pThis, ESI);
+	UpdateOwnedBuilding(pThis, false);
+	return 0;
+}
+
+// the upgrade has been attached to the building it powers up
+DEFINE_HOOK(4409F4, BuildingClass_Put_Upgrade_OwnedBuildings, 6)
+{
+	GET(BuildingClass*, pThis, ESI);
+	GET(BuildingClass*, pToUpgrade, EDI);
+
+	Prereqs::UpgradeAttached(pToUpgrade, pThis->Type);
+
+	if(auto const pExt = HouseExt::ExtMap.Find(pToUpgrade->Owner)) {
+		pExt->SWProvidersDirty = true;
+	}
+	return 0;
+}
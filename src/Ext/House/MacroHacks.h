@@ -5,17 +5,27 @@
  * Don't get it? Don't touch it!
  */
 
-// Westwood, meet my friend the resizable array
-// what? copy pasting original code, leave it be
+#include "../../Misc/TechnoCounters.h"
+
+#include <algorithm>
+#include <vector>
+
+// counts how many of each type the house's teams are still missing, minus
+// the ones that could be recruited. Values and CreationFrames are indexed by
+// type ArrayIndex. returns the indices the teams are missing, ascending. the
+// recruitable objects may have reduced some of their Values to zero.
 template <class TClass, class TType>
-void GetTypeToProduce(HouseClass* pThis, int& ProducingTypeIndex) {
-	auto& CreationFrames = HouseExt::AIProduction_CreationFrames;
-	auto& Values = HouseExt::AIProduction_Values;
-	auto& BestChoices = HouseExt::AIProduction_BestChoices;
+std::vector<int>& CountTypeDemand(
+	HouseClass* pThis, std::vector<int>& Values, std::vector<int>& CreationFrames)
+{
+	// reused, this runs for every AI house and factory type all the time
+	static DynamicVectorClass<TechnoTypeClass *> TaskForceMembers;
+	static std::vector<int> Demanded;
 
 	auto const count = static_cast<unsigned int>(TType::Array->Count);
 	CreationFrames.assign(count, 0x7FFFFFFF);
 	Values.assign(count, 0);
+	Demanded.clear();
 
 	for(auto CurrentTeam : *TeamClass::Array) {
 		if(!CurrentTeam || CurrentTeam->Owner != pThis) {
@@ -30,35 +40,81 @@ void GetTypeToProduce(HouseClass* pThis, int& ProducingTypeIndex) {
 			continue;
 		}
 
-		DynamicVectorClass<TechnoTypeClass *> TaskForceMembers;
+		TaskForceMembers.Count = 0;
 		CurrentTeam->GetTaskForceMissingMemberTypes(TaskForceMembers);
 		for(auto CurrentMember : TaskForceMembers) {
 			if(CurrentMember->WhatAmI() != TType::AbsID) {
 				continue;
 			}
 			auto const Idx = static_cast<unsigned int>(CurrentMember->GetArrayIndex());
-			++Values[Idx];
+			if(!Values[Idx]++) {
+				Demanded.push_back(static_cast<int>(Idx));
+			}
 			if(TeamCreationFrame < CreationFrames[Idx]) {
 				CreationFrames[Idx] = TeamCreationFrame;
 			}
 		}
 	}
 
-	for(auto T : *TClass::Array) {
-		auto const Idx = static_cast<unsigned int>(T->GetType()->GetArrayIndex());
-		if(Values[Idx] > 0 && T->CanBeRecruited(pThis)) {
-			--Values[Idx];
+	// only the house's own objects can be recruited. the owned counts tell
+	// how many of them are left to look at for the types still missing, so
+	// the pass ends after the last one instead of at the end of the array.
+	if(!Demanded.empty()) {
+		static std::vector<int> Owned;
+		Owned.assign(count, 0);
+
+		auto candidates = 0;
+		for(auto const idx : Demanded) {
+			auto const i = static_cast<unsigned int>(idx);
+			Owned[i] = TechnoCounters::CountOwned(pThis, TType::Array->Items[idx]);
+			candidates += Owned[i];
+		}
+
+		for(auto T : *TClass::Array) {
+			if(candidates <= 0) {
+				break;
+			}
+			if(T->Owner != pThis) {
+				continue;
+			}
+			auto const Idx = static_cast<unsigned int>(T->GetType()->GetArrayIndex());
+			if(Values[Idx] > 0) {
+				--Owned[Idx];
+				--candidates;
+				if(T->CanBeRecruited(pThis) && !--Values[Idx]) {
+					// the rest of this type does not matter any more
+					candidates -= Owned[Idx];
+				}
+			}
 		}
 	}
 
+	// the choice below depends on the order of the types
+	std::sort(Demanded.begin(), Demanded.end());
+
+	return Demanded;
+}
+
+// Westwood, meet my friend the resizable array
+// what? copy pasting original code, leave it be
+template <class TClass, class TType>
+void GetTypeToProduce(HouseClass* pThis, int& ProducingTypeIndex) {
+	auto& CreationFrames = HouseExt::AIProduction_CreationFrames;
+	auto& Values = HouseExt::AIProduction_Values;
+	auto& BestChoices = HouseExt::AIProduction_BestChoices;
+
+	auto const& Demanded = CountTypeDemand<TClass, TType>(pThis, Values, CreationFrames);
+
 	BestChoices.clear();
 
 	int BestValue = -1;
 	int EarliestTypenameIndex = -1;
 	int EarliestFrame = 0x7FFFFFFF;
 
-	for(auto i = 0u; i < count; ++i) {
-		auto const TT = TType::Array->Items[static_cast<int>(i)];
+	// types without demand would be skipped anyway
+	for(auto const idx : Demanded) {
+		auto const i = static_cast<unsigned int>(idx);
+		auto const TT = TType::Array->Items[idx];
 		int CurrentValue = Values[i];
 		if(CurrentValue <= 0 || !pThis->CanBuild(TT, false, false)
 			|| TT->GetActualCost(pThis) > pThis->Available_Money())
@@ -70,9 +126,9 @@ void GetTypeToProduce(HouseClass* pThis, int& ProducingTypeIndex) {
 			BestValue = CurrentValue;
 			BestChoices.clear();
 		}
-		BestChoices.push_back(static_cast<int>(i));
+		BestChoices.push_back(idx);
 		if(EarliestFrame > CreationFrames[i] || EarliestTypenameIndex == -1) {
-			EarliestTypenameIndex = static_cast<int>(i);
+			EarliestTypenameIndex = idx;
 			EarliestFrame = CreationFrames[i];
 		}
 	}
@@ -268,8 +268,8 @@ bool RulesExt::LoadGlobals(AresStreamReader& Stm) {
 }
 
 bool RulesExt::SaveGlobals(AresStreamWriter& Stm) {
-	for(const auto& tab : TabCameos) {
-		Savegame::WriteAresStream(Stm, tab);
+	for(auto i = 0; i < 4; ++i) {
+		Savegame::WriteAresStream(Stm, GetSortedCameos(i));
 	}
 
 	return Stm.Success();
@@ -186,6 +186,15 @@ public:
 
 	static void ClearCameos();
 
+	// the slot of the cameo in TabCameos[tab], or -1 if it is not listed
+	static int FindCameo(int tab, AbstractType type, int index);
+
+	// appends the cameo. the tab is sorted once before it is read again.
+	static bool AddCameo(int tab, CameoDataStruct const& cameo);
+
+	// the tab's cameos, sorted as the game expects them
+	static DynamicVectorClass<CameoDataStruct>& GetSortedCameos(int tab);
+
 	static void Clear() {
 		ClearCameos();
 		Allocate(RulesClass::Instance);
@@ -1,6 +1,7 @@
 #include "Body.h"
 
 #include "../../Misc/Exception.h"
+#include "../../Utilities/Stopwatch.h"
 
 #include <FactoryClass.h>
 #include <SuperClass.h>
@@ -9,8 +10,47 @@
 #include <BuildingClass.h>
 #include <HouseClass.h>
 
+#include <algorithm>
+#include <unordered_map>
+
 DynamicVectorClass<CameoDataStruct> RulesExt::TabCameos[4];
 
+namespace {
+	// where each cameo of a tab is, and how many of the leading cameos are
+	// sorted. new cameos are appended and sorted in one go when the tab is
+	// read by position the next time.
+	struct CameoIndex {
+		std::unordered_map<unsigned long long, int> Slots;
+		int SortedCount{ 0 };
+		bool Valid{ false };
+
+		static unsigned long long GetKey(AbstractType type, int index) {
+			return (static_cast<unsigned long long>(type) << 32)
+				| static_cast<unsigned int>(index);
+		}
+
+		void Reset() {
+			this->Slots.clear();
+			this->SortedCount = 0;
+			this->Valid = false;
+		}
+	};
+
+	CameoIndex CameoIndexes[4];
+
+	// time spent rechecking and sorting the sidebar since it was cleared
+	struct CameoStatistics {
+		unsigned int Rechecks{ 0 };
+		double RecheckMilliseconds{ 0.0 };
+		double MaxRecheckMilliseconds{ 0.0 };
+		unsigned int Added{ 0 };
+		unsigned int Sorts{ 0 };
+		double SortMilliseconds{ 0.0 };
+	};
+
+	CameoStatistics Statistics;
+}
+
 template <typename... Args>
 void DumpAndExit [[noreturn]] (const char* pMessage, Args... args) {
 	//Debug::FullDump();
@@ -24,6 +64,73 @@ void RulesExt::ClearCameos() {
 		cameos.CapacityIncrement = 100;
 		cameos.Reserve(100);
 	}
+
+	for(auto& index : CameoIndexes) {
+		index.Reset();
+	}
+
+	if(Statistics.Rechecks || Statistics.Sorts) {
+		Debug::Log("Sidebar: %u rechecks took %.2f ms (%.2f ms at most), %u "
+			"cameos added in %u sorts taking %.2f ms.\n", Statistics.Rechecks,
+			Statistics.RecheckMilliseconds, Statistics.MaxRecheckMilliseconds,
+			Statistics.Added, Statistics.Sorts, Statistics.SortMilliseconds);
+	}
+
+	Statistics = CameoStatistics();
+}
+
+int RulesExt::FindCameo(int const tab, AbstractType const type, int const index) {
+	auto const& cameos = RulesExt::TabCameos[tab];
+	auto& data = CameoIndexes[tab];
+
+	if(!data.Valid) {
+		data.Slots.clear();
+		for(auto i = 0; i < cameos.Count; ++i) {
+			auto const& cameo = cameos.Items[i];
+			data.Slots[CameoIndex::GetKey(cameo.ItemType, cameo.ItemIndex)] = i;
+		}
+		data.Valid = true;
+	}
+
+	auto const it = data.Slots.find(CameoIndex::GetKey(type, index));
+	return (it != data.Slots.end()) ? it->second : -1;
+}
+
+bool RulesExt::AddCameo(int const tab, CameoDataStruct const& cameo) {
+	auto& cameos = RulesExt::TabCameos[tab];
+	if(!cameos.AddItem(cameo)) {
+		return false;
+	}
+
+	// appending does not move the other cameos
+	auto& data = CameoIndexes[tab];
+	if(data.Valid) {
+		data.Slots[CameoIndex::GetKey(cameo.ItemType, cameo.ItemIndex)] = cameos.Count - 1;
+	}
+
+	++Statistics.Added;
+	return true;
+}
+
+DynamicVectorClass<CameoDataStruct>& RulesExt::GetSortedCameos(int const tab) {
+	auto& cameos = RulesExt::TabCameos[tab];
+	auto& data = CameoIndexes[tab];
+
+	if(data.SortedCount < cameos.Count) {
+		Stopwatch timer;
+
+		auto const middle = cameos.begin() + data.SortedCount;
+		std::sort(middle, cameos.end());
+		std::inplace_merge(cameos.begin(), middle, cameos.end());
+
+		data.SortedCount = cameos.Count;
+		data.Valid = false;
+
+		++Statistics.Sorts;
+		Statistics.SortMilliseconds += timer.ElapsedMilliseconds();
+	}
+
+	return cameos;
 }
 
 int IndexOfTab(TabDataStruct * tab) {
@@ -63,18 +170,17 @@ DEFINE_HOOK(6A61B1, SidebarClass_SetFactoryForObject, 0)
 	GET(int, ItemIndex, EBP);
 	GET_STACK(FactoryClass *, Factory, STACK_OFFS(0xC, -0x4));
 
-	for(auto& cameo : RulesExt::TabCameos[TabIndex]) {
-		if(cameo.ItemIndex == ItemIndex && cameo.ItemType == ItemType) {
-			cameo.CurrentFactory = Factory;
-			auto &Tab = MouseClass::Instance->Tabs[TabIndex];
-			Tab.unknown_3C = 1;
-			Tab.unknown_3D = 1;
-			MouseClass::Instance->RedrawSidebar(0);
-			return Found;
-		}
+	auto const slot = RulesExt::FindCameo(TabIndex, ItemType, ItemIndex);
+	if(slot < 0) {
+		return NotFound;
 	}
 
-	return NotFound;
+	RulesExt::TabCameos[TabIndex].Items[slot].CurrentFactory = Factory;
+	auto &Tab = MouseClass::Instance->Tabs[TabIndex];
+	Tab.unknown_3C = 1;
+	Tab.unknown_3D = 1;
+	MouseClass::Instance->RedrawSidebar(0);
+	return Found;
 }
 
 // don't check for 75 cameos in active tab
@@ -86,10 +192,8 @@ DEFINE_HOOK(6A63B7, SidebarClass_AddCameo_SkipSizeCheck, 0)
 	GET(AbstractType, ItemType, ESI);
 	GET(int, ItemIndex, EBP);
 
-	for(auto const& cameo : RulesExt::TabCameos[TabIndex]) {
-		if(cameo.ItemIndex == ItemIndex && cameo.ItemType == ItemType) {
-			return AlreadyExists;
-		}
+	if(RulesExt::FindCameo(TabIndex, ItemType, ItemIndex) >= 0) {
+		return AlreadyExists;
 	}
 
 	R->EDI<TabDataStruct *>(&MouseClass::Instance->Tabs[TabIndex]);
@@ -116,13 +220,8 @@ DEFINE_HOOK(6A8710, TabCameoListClass_AddCameo_ReplaceItAll, 0)
 
 	//Debug::Log("Adding cameo at tab %d, slot %d of %d: AbsID = %d, Index = %d\n", TabIndex, InsertIndex, cameos.Count, ItemType, ItemIndex);
 
-	if(cameos.AddItem(newCameo)) {
+	if(RulesExt::AddCameo(TabIndex, newCameo)) {
 		++pTab->CameoCount;
-
-		auto const old_end = cameos.end() - 1;
-		auto const it = std::lower_bound(cameos.begin(), old_end, newCameo);
-		std::copy_backward(it, old_end, cameos.end());
-		*it = newCameo;
 	} else {
 		Debug::Log("Adding cameo failed?!\n");
 	}
@@ -137,7 +236,7 @@ DEFINE_HOOK(6A8D1C, TabSidebarCameoClass_MouseMove_GetCameos1, 0)
 
 	GET(TabDataStruct *, pTab, EBX);
 	auto TabIndex = IndexOfTab(pTab);
-	auto &cameos = RulesExt::TabCameos[TabIndex];
+	auto &cameos = RulesExt::GetSortedCameos(TabIndex);
 	if(cameos.Count != CameoCount) {
 		DumpAndExit("Unsynchronized cameo counts @ %s: old %d, new %d\n", __FUNCTION__, CameoCount, cameos.Count);
 	}
@@ -158,7 +257,7 @@ DEFINE_HOOK(6A8DB5, TabSidebarCameoClass_MouseMove_GetCameos2, 0)
 
 	GET(TabDataStruct *, pTab, EBX);
 	auto TabIndex = IndexOfTab(pTab);
-	auto &cameos = RulesExt::TabCameos[TabIndex];
+	auto &cameos = RulesExt::GetSortedCameos(TabIndex);
 	if(cameos.Count != CameoCount) {
 		DumpAndExit("Unsynchronized cameo counts @ %s: old %d, new %d\n", __FUNCTION__, CameoCount, cameos.Count);
 	}
@@ -181,7 +280,7 @@ DEFINE_HOOK(6A8F6C, TabSidebarCameoClass_MouseMove_GetCameos3, 0)
 	GET_STACK(int, unused, 0x20);
 
 	auto TabIndex = IndexOfTab(pTab);
-	auto &cameos = RulesExt::TabCameos[TabIndex];
+	auto &cameos = RulesExt::GetSortedCameos(TabIndex);
 	if(cameos.Count != pTab->CameoCount) {
 		DumpAndExit("Unsynchronized cameo counts @ %s: old %d, new %d\n", __FUNCTION__, pTab->CameoCount, cameos.Count);
 	}
@@ -203,7 +302,7 @@ DEFINE_HOOK(6A9304, CameoClass_GetTip_NoLimit, 0)
 {
 	GET(int, CameoIndex, EAX);
 
-	auto &cameos = RulesExt::TabCameos[MouseClass::Instance->ActiveTabIndex];
+	auto &cameos = RulesExt::GetSortedCameos(MouseClass::Instance->ActiveTabIndex);
 	if(CameoIndex >= cameos.Count) {
 		DumpAndExit("Bad cameo count @ %s: max %d, request %d\n", __FUNCTION__, cameos.Count, CameoIndex);
 	}
@@ -219,7 +318,7 @@ DEFINE_HOOK(6A9747, TabCameoListClass_Draw_GetCameo1, 0)
 {
 	GET(int, CameoIndex, ECX);
 
-	auto &cameos = RulesExt::TabCameos[MouseClass::Instance->ActiveTabIndex];
+	auto &cameos = RulesExt::GetSortedCameos(MouseClass::Instance->ActiveTabIndex);
 	if(CameoIndex >= cameos.Count) {
 		DumpAndExit("Bad cameo count @ %s: max %d, request %d\n", __FUNCTION__, cameos.Count, CameoIndex);
 	}
@@ -243,7 +342,7 @@ DEFINE_HOOK(6A9866, TabCameoListClass_Draw_Test10_1, 0)
 {
 	GET(int, CameoIndex, ECX);
 
-	auto &cameos = RulesExt::TabCameos[MouseClass::Instance->ActiveTabIndex];
+	auto &cameos = RulesExt::GetSortedCameos(MouseClass::Instance->ActiveTabIndex);
 	if(CameoIndex >= cameos.Count) {
 		DumpAndExit("Bad cameo count @ %s: max %d, request %d\n", __FUNCTION__, cameos.Count, CameoIndex);
 	}
@@ -258,7 +357,7 @@ DEFINE_HOOK(6A9886, TabCameoListClass_Draw_Test10_2, 0)
 {
 	GET(int, CameoIndex, EAX);
 
-	auto &cameos = RulesExt::TabCameos[MouseClass::Instance->ActiveTabIndex];
+	auto &cameos = RulesExt::GetSortedCameos(MouseClass::Instance->ActiveTabIndex);
 	if(CameoIndex >= cameos.Count) {
 		DumpAndExit("Bad cameo count @ %s: max %d, request %d\n", __FUNCTION__, cameos.Count, CameoIndex);
 	}
@@ -279,7 +378,7 @@ DEFINE_HOOK(6A95C8, TabCameoListClass_Draw_TestF10, 0)
 {
 	GET(int, CameoIndex, EAX);
 
-	auto &cameos = RulesExt::TabCameos[MouseClass::Instance->ActiveTabIndex];
+	auto &cameos = RulesExt::GetSortedCameos(MouseClass::Instance->ActiveTabIndex);
 	if(CameoIndex >= cameos.Count) {
 		DumpAndExit("Bad cameo count @ %s: max %d, request %d\n", __FUNCTION__, cameos.Count, CameoIndex);
 	}
@@ -301,7 +400,7 @@ DEFINE_HOOK(6A9B4F, TabCameoListClass_Draw_TestFlashFrame, 0)
 {
 	GET(int, CameoIndex, EAX);
 
-	auto &cameos = RulesExt::TabCameos[MouseClass::Instance->ActiveTabIndex];
+	auto &cameos = RulesExt::GetSortedCameos(MouseClass::Instance->ActiveTabIndex);
 	if(CameoIndex >= cameos.Count) {
 		DumpAndExit("Bad cameo count @ %s: max %d, request %d\n", __FUNCTION__, cameos.Count, CameoIndex);
 	}
@@ -318,7 +417,7 @@ DEFINE_HOOK(6A9EBA, TabCameoListClass_Draw_Test10_3, 0)
 {
 	GET(int, CameoIndex, EAX);
 
-	auto &cameos = RulesExt::TabCameos[MouseClass::Instance->ActiveTabIndex];
+	auto &cameos = RulesExt::GetSortedCameos(MouseClass::Instance->ActiveTabIndex);
 	if(CameoIndex >= cameos.Count) {
 		DumpAndExit("Bad cameo count @ %s: max %d, request %d\n", __FUNCTION__, cameos.Count, CameoIndex);
 	}
@@ -333,7 +432,7 @@ DEFINE_HOOK(6AAD2F, SidebarClass_ProcessCameoClick_LoadCameoData1, 0)
 {
 	GET(int, CameoIndex, ESI);
 
-	auto &cameos = RulesExt::TabCameos[MouseClass::Instance->ActiveTabIndex];
+	auto &cameos = RulesExt::GetSortedCameos(MouseClass::Instance->ActiveTabIndex);
 	if(CameoIndex >= cameos.Count) {
 		return 0x6AB94F;
 	}
@@ -359,7 +458,7 @@ DEFINE_HOOK(6AB0B0, SidebarClass_ProcessCameoClick_LoadCameo2, 0)
 {
 	GET(int, CameoIndex, ESI);
 
-	auto &cameos = RulesExt::TabCameos[MouseClass::Instance->ActiveTabIndex];
+	auto &cameos = RulesExt::GetSortedCameos(MouseClass::Instance->ActiveTabIndex);
 	if(CameoIndex >= cameos.Count) {
 		DumpAndExit("Bad cameo count @ %s: max %d, request %d\n", __FUNCTION__, cameos.Count, CameoIndex);
 	}
@@ -394,7 +493,7 @@ DEFINE_HOOK(6AB577, SidebarClass_ProcessCameoClick_FixOffset3, 0)
 	GET(int, CameoIndex, ESI);
 	GET_STACK(FactoryClass *, SavedFactory, 0x18);
 
-	auto &cameos = RulesExt::TabCameos[MouseClass::Instance->ActiveTabIndex];
+	auto &cameos = RulesExt::GetSortedCameos(MouseClass::Instance->ActiveTabIndex);
 	if(CameoIndex >= cameos.Count) {
 		DumpAndExit("Bad cameo count @ %s: max %d, request %d\n", __FUNCTION__, cameos.Count, CameoIndex);
 	}
@@ -443,7 +542,7 @@ DEFINE_HOOK(6AB802, SidebarClass_ProcessCameoClick_FixOffset6, 0)
 {
 	GET(int, CameoIndex, EAX);
 
-	auto &cameos = RulesExt::TabCameos[MouseClass::Instance->ActiveTabIndex];
+	auto &cameos = RulesExt::GetSortedCameos(MouseClass::Instance->ActiveTabIndex);
 	if(CameoIndex >= cameos.Count) {
 		DumpAndExit("Bad cameo count @ %s: max %d, request %d\n", __FUNCTION__, cameos.Count, CameoIndex);
 	}
@@ -481,7 +580,7 @@ DEFINE_HOOK(6ABBCB, TabCameoListClass_AbandonCameosFromFactory_GetPointer1, 0)
 
 	GET(TabDataStruct *, pTab, ESI);
 	auto TabIndex = IndexOfTab(pTab);
-	auto &cameos = RulesExt::TabCameos[TabIndex];
+	auto &cameos = RulesExt::GetSortedCameos(TabIndex);
 	if(CameoCount != cameos.Count) {
 		DumpAndExit("Bad cameo count @ %s: old %d, new %d\n", __FUNCTION__, cameos.Count, CameoCount);
 	}
@@ -504,7 +603,8 @@ DEFINE_HOOK(6AC6D9, MapClass_FlashCameo, 0)
 	GET(int, ItemIndex, ESI);
 	GET_STACK(int, Duration, 0x10);
 
-	auto &cameos = RulesExt::TabCameos[TabIndex];
+	// the first match has to be the first in sidebar order
+	auto &cameos = RulesExt::GetSortedCameos(static_cast<int>(TabIndex));
 	for(auto i = 0; i < cameos.Count; ++i) {
 		auto &cameo = cameos[i];
 		if(cameo.ItemIndex == ItemIndex) {
@@ -522,7 +622,7 @@ DEFINE_HOOK(6AA6EA, TabCameoListClass_RecheckCameos_Memcpy, 0)
 
 	GET(TabDataStruct *, pTab, EBP);
 	auto TabIndex = IndexOfTab(pTab);
-	auto &cameos = RulesExt::TabCameos[TabIndex];
+	auto &cameos = RulesExt::GetSortedCameos(TabIndex);
 	if(CameoIndex >= cameos.Count) {
 		DumpAndExit("Bad cameo count @ %s: max %d, request %d\n", __FUNCTION__, cameos.Count, CameoIndex);
 	}
@@ -540,7 +640,7 @@ DEFINE_HOOK(6AA711, TabCameoListClass_RecheckCameos_FilterAllowedCameos, 0)
 {
 	GET(TabDataStruct *, pTab, EBP);
 	auto TabIndex = IndexOfTab(pTab);
-	auto &cameos = RulesExt::TabCameos[TabIndex];
+	auto &cameos = RulesExt::GetSortedCameos(TabIndex);
 
 	if(cameos.Count != pTab->CameoCount) {
 		DumpAndExit("Bad cameo count @ %s: old %d, new %d\n", __FUNCTION__, pTab->CameoCount, cameos.Count);
@@ -549,6 +649,9 @@ DEFINE_HOOK(6AA711, TabCameoListClass_RecheckCameos_FilterAllowedCameos, 0)
 	GET_STACK(int, StripLength, 0x30);
 	GET_STACK(CameoDataStruct *, StripData, 0x1C);
 
+	Stopwatch timer;
+	auto removed = false;
+
 	for(auto ix = cameos.Count; ix > 0; --ix) {
 		auto &cameo = cameos[ix - 1];
 
@@ -605,10 +708,24 @@ DEFINE_HOOK(6AA711, TabCameoListClass_RecheckCameos_FilterAllowedCameos, 0)
 			}
 			--pTab->CameoCount;
 
+			removed = true;
+
 			R->Stack8(0x17, 1);
 		}
 	}
 
+	// removing keeps the order, but moves the cameos
+	if(removed) {
+		auto& data = CameoIndexes[TabIndex];
+		data.SortedCount = cameos.Count;
+		data.Valid = false;
+	}
+
+	auto const elapsed = timer.ElapsedMilliseconds();
+	++Statistics.Rechecks;
+	Statistics.RecheckMilliseconds += elapsed;
+	Statistics.MaxRecheckMilliseconds = std::max(Statistics.MaxRecheckMilliseconds, elapsed);
+
 	return 0x6AAAB3;
 }
 
@@ -618,7 +735,7 @@ DEFINE_HOOK(6AAC10, TabCameoListClass_RecheckCameos_GetPointer, 0)
 
 	GET(TabDataStruct *, pTab, EBP);
 	auto TabIndex = IndexOfTab(pTab);
-	auto &cameos = RulesExt::TabCameos[TabIndex];
+	auto &cameos = RulesExt::GetSortedCameos(TabIndex);
 	R->ECX<CameoDataStruct *>(cameos.Items);
 
 	return 0x6AAC17;
@@ -632,7 +749,7 @@ DEFINE_HOOK(6A7D4A, MouseClass_RecheckCameos_TrapAlignment, 6)
 
 	auto pTab = reinterpret_cast<TabDataStruct *>(pTabData);
 	auto TabIndex = IndexOfTab(pTab);
-	auto &cameos = RulesExt::TabCameos[TabIndex];
+	auto &cameos = RulesExt::GetSortedCameos(TabIndex);
 	if(cameos.Count != pTab->CameoCount) {
 		DumpAndExit("Bad cameo count @ %s: old %d, new %d\n", __FUNCTION__, pTab->CameoCount, cameos.Count);
 	}
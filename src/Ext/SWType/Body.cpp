@@ -118,6 +118,10 @@ void SWTypeExt::ExtData::LoadFromINIFile(CCINIClass* pINI)
 {
 	const char * section = this->OwnerObject()->get_ID();
 
+	// every ini can change the ranges of the techno types
+	this->SW_DesignatorsMaxRange = -1;
+	this->SW_InhibitorsMaxRange = -1;
+
 	if(!pINI->GetSection(section)) {
 		return;
 	}
@@ -920,6 +924,8 @@ void SWTypeExt::ExtData::Serialize(T& Stm) {
 void SWTypeExt::ExtData::LoadFromStream(AresStreamReader &Stm) {
 	Extension<SuperWeaponTypeClass>::LoadFromStream(Stm);
 	this->Serialize(Stm);
+	this->SW_DesignatorsMaxRange = -1;
+	this->SW_InhibitorsMaxRange = -1;
 }
 
 void SWTypeExt::ExtData::SaveToStream(AresStreamWriter &Stm) {
@@ -251,6 +251,11 @@ public:
 		ValueableVector<TechnoTypeClass*> SW_Inhibitors;
 		Valueable<bool> SW_AnyInhibitor;
 
+		// the largest range of all designator and inhibitor types, or -1
+		// if not yet computed. not saved, recomputed on first use.
+		int SW_DesignatorsMaxRange;
+		int SW_InhibitorsMaxRange;
+
 		CustomPalette CameoPal;
 
 		// Unit Delivery
@@ -326,6 +331,8 @@ public:
 			SW_AnyDesignator(false),
 			SW_Inhibitors(),
 			SW_AnyInhibitor(false),
+			SW_DesignatorsMaxRange(-1),
+			SW_InhibitorsMaxRange(-1),
 			SW_RequiredHouses(0xFFFFFFFFu),
 			SW_ForbiddenHouses(0u),
 			HandledByNewSWType(SuperWeaponType::Invalid),
@@ -6,6 +6,9 @@
 #include <MouseClass.h>
 #include <SuperClass.h>
 
+#include <algorithm>
+#include <iterator>
+
 // cache all super weapon statuses
 struct SWStatus {
 	bool Available;
@@ -13,17 +16,71 @@ struct SWStatus {
 	bool Charging;
 };
 
+// counts how often the provider lists were rebuilt, and how often statuses
+// were requested, logged once a minute
+struct SWStatusStatistics {
+	int Frame;
+	int ProviderRebuilds;
+	int StatusUpdates;
+};
+
+static SWStatusStatistics StatusStatistics = {0, 0, 0};
+
+// whether this building provides any super weapon through its type or one of
+// its upgrades, regardless of whether the super weapon is available.
+bool ProvidesSuperWeapons(BuildingClass* pBld) {
+	auto HasSuperWeapons = [](BuildingTypeClass* pType) {
+		if(const auto pExt = BuildingTypeExt::ExtMap.Find(pType)) {
+			const auto count = pExt->GetSuperWeaponCount();
+			for(auto i = 0u; i < count; ++i) {
+				if(pExt->GetSuperWeaponIndex(i) > -1) {
+					return true;
+				}
+			}
+		}
+		return false;
+	};
+
+	return HasSuperWeapons(pBld->Type)
+		|| std::any_of(std::begin(pBld->Upgrades), std::end(pBld->Upgrades), HasSuperWeapons);
+}
+
+// the buildings of this house that can provide super weapons. most buildings
+// don't, so only these have to be looked at on every update.
+std::vector<BuildingClass*> const& GetSuperWeaponProviders(HouseClass* pHouse) {
+	auto const pExt = HouseExt::ExtMap.Find(pHouse);
+
+	if(pExt->SWProvidersDirty || pExt->SWProvidersBuildingCount != pHouse->Buildings.Count) {
+		auto& Providers = pExt->SWProviders;
+		Providers.clear();
+
+		for(auto pBld : pHouse->Buildings) {
+			if(ProvidesSuperWeapons(pBld)) {
+				Providers.push_back(pBld);
+			}
+		}
+
+		pExt->SWProvidersDirty = false;
+		pExt->SWProvidersBuildingCount = pHouse->Buildings.Count;
+		++StatusStatistics.ProviderRebuilds;
+	}
+
+	return pExt->SWProviders;
+}
+
 // This function controls the availability of super weapons. If a you want to
 // add to or change the way the game thinks a building provides a super weapon,
 // change the lambda UpdateStatus. Available means this super weapon exists at
 // all. Setting it to false removes the super weapon. PowerSourced controls
 // whether the super weapon charges or can be used.
 std::vector<SWStatus> GetSuperWeaponStatuses(HouseClass* pHouse) {
-	std::vector<SWStatus> Statuses(pHouse->Supers.Count, {false, false, false});
+	std::vector<SWStatus> Statuses(static_cast<size_t>(pHouse->Supers.Count), {false, false, false});
+
+	++StatusStatistics.StatusUpdates;
 
 	// look at every sane building this player owns, if it is not defeated already.
 	if(!pHouse->Defeated) {
-		for(auto pBld : pHouse->Buildings) {
+		for(auto pBld : GetSuperWeaponProviders(pHouse)) {
 			if(pBld->IsAlive && !pBld->InLimbo) {
 				TechnoExt::ExtData *pExt = TechnoExt::ExtMap.Find(pBld);
 
@@ -102,7 +159,18 @@ DEFINE_HOOK(50AF10, HouseClass_UpdateSuperWeaponsOwned, 5)
 {
 	GET(HouseClass *, pThis, ECX);
 
-	auto Statuses = GetSuperWeaponStatuses(pThis);
+	auto& Stats = StatusStatistics;
+	if(Unsorted::CurrentFrame - Stats.Frame >= 900) {
+		if(Stats.StatusUpdates) {
+			Debug::Log(Debug::Severity::Verbose, "Super weapon statuses were "
+				"updated %d times since frame %d, super weapon providers were "
+				"collected %d times.\n", Stats.StatusUpdates, Stats.Frame,
+				Stats.ProviderRebuilds);
+		}
+		Stats = {Unsorted::CurrentFrame, 0, 0};
+	}
+
+	auto const Statuses = GetSuperWeaponStatuses(pThis);
 
 	// now update every super weapon that is valid.
 	// if this weapon has not been granted there's no need to update
@@ -110,7 +178,7 @@ DEFINE_HOOK(50AF10, HouseClass_UpdateSuperWeaponsOwned, 5)
 		if(pSuper->Granted) {
 			auto pType = pSuper->Type;
 			auto index = pType->ArrayIndex;
-			auto& status = Statuses[index];
+			auto const& status = Statuses[index];
 
 			// is this a super weapon to be updated?
 			// sw is bound to a building and no single-shot => create goody otherwise
@@ -156,13 +224,13 @@ DEFINE_HOOK(50B1D0, HouseClass_UpdateSuperWeaponsUnavailable, 6)
 	GET(HouseClass*, pThis, ECX);
 
 	if(!pThis->Defeated) {
-		auto Statuses = GetSuperWeaponStatuses(pThis);
+		auto const Statuses = GetSuperWeaponStatuses(pThis);
 
 		// update all super weapons not repeatedly available
 		for(auto pSuper : pThis->Supers) {
 			if(!pSuper->Granted || pSuper->OneTime) {
 				auto index = pSuper->Type->ArrayIndex;
-				auto& status = Statuses[index];
+				auto const& status = Statuses[index];
 
 				if(status.Available) {
 					pSuper->Grant(false, pThis->IsPlayer(), !status.PowerSourced);
@@ -1,6 +1,7 @@
 #include "Body.h"
 
 #include "../../Misc/SavegameDef.h"
+#include "../../Misc/TechnoCounters.h"
 
 #include <HouseClass.h>
 #include <TechnoTypeClass.h>
@@ -53,16 +54,8 @@ bool TEventExt::ExtData::TechTypeExists()
 	}
 
 	if(pType->Insignificant || pType->DontScore) {
-		// check each techno and subtract one if the type matches.
-		for(auto pTechno : *TechnoClass::Array) {
-			if(pTechno->GetTechnoType() == pType) {
-				count--;
-
-				if(count <= 0) {
-					return true;
-				}
-			}
-		}
+		// the game doesn't keep track of this type, but we do.
+		count -= TechnoCounters::CountExisting(pType);
 	} else {
 		// decreases count by the number of owned techno types. iff count is zero or less,
 		// this techno type exists at least 'count' times.
@@ -95,13 +88,10 @@ bool TEventExt::ExtData::TechTypeDoesNotExist()
 	}
 
 	if(pType->Insignificant || pType->DontScore) {
-		// we have to loop through all technos here, because game doesn't
-		// keep track of this type.
-		for(auto pTechno : *TechnoClass::Array) {
-			if(pTechno->GetTechnoType() == pType) {
-				return false;
-			}
-		}		
+		// the game doesn't keep track of this type, but we do.
+		if(TechnoCounters::CountExisting(pType) > 0) {
+			return false;
+		}
 	} else {
 		// if any house owns this, this check fails.
 		for(auto pHouse : *HouseClass::Array) {
@@ -5,6 +5,8 @@
 #include "../WeaponType/Body.h"
 #include "../../Misc/SWTypes.h"
 #include "../../Misc/PoweredUnitClass.h"
+#include "../../Misc/TechnoCounters.h"
+#include "../../Misc/TechnoGrid.h"
 #include "../../Utilities/TemplateDef.h"
 
 #include <AnimClass.h>
@@ -865,6 +867,7 @@ InfantryClass* TechnoExt::RecoverHijacker(FootClass* const pThis) {
 			pExt->HijackerHouse : pThis->Owner;
 
 		pThis->HijackerInfantryType = -1;
+		TechnoCounters::UpdateHijacked(pThis);
 
 		auto const pTypeExt = TechnoTypeExt::ExtMap.Find(pType);
 		if(!pTypeExt->HijackerOneTime && pOwner && !pOwner->Defeated) {
@@ -1038,6 +1041,7 @@ bool TechnoExt::ExtData::PerformActionHijack(TechnoClass* const pTarget) const {
 		// save the hijacker's properties
 		if(action == AresAction::Hijack) {
 			pTarget->HijackerInfantryType = pType->ArrayIndex;
+			TechnoCounters::UpdateHijacked(pTarget);
 			pDestExt->HijackerHouse = pThis->Owner;
 			pDestExt->HijackerHealth = pThis->Health;
 			pDestExt->HijackerVeterancy = pThis->Veterancy.Veterancy;
@@ -1309,6 +1313,7 @@ void TechnoExt::ExtData::SetSpotlight(BuildingLightClass* pSpotlight) {
 			GameDelete(this->Spotlight);
 		}
 		this->Spotlight = pSpotlight;
+		TechnoExt::ExtMap.Watch(this, pSpotlight);
 	}
 
 	if(auto pBld = abstract_cast<BuildingClass*>(this->OwnerObject())) {
@@ -1365,6 +1370,11 @@ void TechnoExt::ExtData::Serialize(T& Stm) {
 void TechnoExt::ExtData::LoadFromStream(AresStreamReader &Stm) {
 	Extension<TechnoClass>::LoadFromStream(Stm);
 	this->Serialize(Stm);
+
+	// the counted types are not saved
+	this->CountedType = nullptr;
+	this->CountedOwner = -1;
+	TechnoCounters::Invalidate();
 }
 
 void TechnoExt::ExtData::SaveToStream(AresStreamWriter &Stm) {
@@ -1400,6 +1410,23 @@ void TechnoExt::ExtContainer::InvalidatePointer(void* ptr, bool bRemoved) {
 	AnnounceInvalidPointer(TechnoExt::ActiveBuildingLight, ptr);
 }
 
+void TechnoExt::ExtContainer::WatchAll(TechnoExt::ExtData* const pExt) {
+	this->Watch(pExt, pExt->GarrisonedIn);
+	this->Watch(pExt, pExt->MyOriginalTemporal);
+	this->Watch(pExt, pExt->Spotlight);
+
+	for(auto const& Item : pExt->AttachedEffects) {
+		this->Watch(pExt, Item.Invoker);
+		this->Watch(pExt, Item.Animation.get());
+	}
+
+	if(pExt->RadarJam) {
+		for(auto const& pBld : pExt->RadarJam->GetJammed()) {
+			this->Watch(pExt, pBld);
+		}
+	}
+}
+
 // =============================
 // container hooks
 
@@ -1416,6 +1443,8 @@ DEFINE_HOOK(6F4500, TechnoClass_DTOR, 5)
 	GET(TechnoClass*, pItem, ECX);
 
 	//TechnoExt::ExtData *pItemExt = TechnoExt::ExtMap.Find(pItem);
+	TechnoCounters::Remove(pItem);
+	TechnoGrid::Instance.Remove(pItem);
 	TechnoExt::ExtMap.Remove(pItem);
 	return 0;
 }
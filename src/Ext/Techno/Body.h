@@ -89,6 +89,11 @@ public:
 		SuperClass* SuperWeapon; // the super weapon somehow attached to this (not provided by this)
 		AbstractClass* SuperTarget; // the attached super weapon's target (if any)
 
+		TechnoTypeClass* CountedType; // the type this is counted as (not saved, see TechnoCounters)
+		int CountedOwner; // the ArrayIndex of the house this is counted for, or -1 (not saved, see TechnoCounters)
+
+		int GridIndex; // the entry in the techno grid, or -1 (not saved, see TechnoGrid)
+
 		ExtData(TechnoClass* OwnerObject) : Extension<TechnoClass>(OwnerObject),
 			idxSlot_Wave(0),
 			idxSlot_Beam(0),
@@ -113,6 +118,9 @@ public:
 			PayloadCreated(false),
 			SuperWeapon(nullptr),
 			SuperTarget(nullptr),
+			CountedType(nullptr),
+			CountedOwner(-1),
+			GridIndex(-1),
 			OriginalHouseType(nullptr),
 			AttachEffects_RecreateAnims(false),
 			AttachedTechnoEffect_isset(false),
@@ -127,12 +135,17 @@ public:
 			this->SetSpotlight(nullptr);
 		}
 
-		// when any pointer in the game expires, this is called - be sure to tell everyone we own to invalidate it
+		// when any pointer in the game expires, this is called - be sure to tell everyone we own to invalidate it.
+		// every pointer handled here has to be registered with ExtMap.Watch when it is set, see ExtContainer::WatchAll
 		virtual void InvalidatePointer(void *ptr, bool bRemoved) override {
 			AnnounceInvalidPointer(this->GarrisonedIn, ptr);
 			this->InvalidateAttachEffectPointer(ptr);
 			AnnounceInvalidPointer(this->MyOriginalTemporal, ptr);
 			AnnounceInvalidPointer(this->Spotlight, ptr);
+
+			if(this->RadarJam) {
+				this->RadarJam->InvalidatePointer(ptr, bRemoved);
+			}
 		}
 
 		virtual void LoadFromStream(AresStreamReader &Stm) override;
@@ -180,7 +193,7 @@ public:
 		void Serialize(T& Stm);
 	};
 
-	class ExtContainer final : public Container<TechnoExt> {
+	class ExtContainer final : public Container<TechnoExt, ContainerSlotMap> {
 	public:
 		ExtContainer();
 		~ExtContainer();
@@ -202,6 +215,12 @@ public:
 		}
 
 		virtual void InvalidatePointer(void *ptr, bool bRemoved) override;
+
+		virtual bool UsesWatchers() const override {
+			return true;
+		}
+
+		virtual void WatchAll(TechnoExt::ExtData* pExt) override;
 	};
 
 	static ExtContainer ExtMap;
@@ -60,6 +60,7 @@ DEFINE_HOOK(435820, BuildingLightClass_CTOR, 6)
 
 	if(auto pExt = TechnoExt::ExtMap.Find(T)) {
 		pExt->Spotlight = BL;
+		TechnoExt::ExtMap.Watch(pExt, BL);
 	}
 	return 0;
 }
@@ -10,6 +10,7 @@
 #include "../../Misc/Debug.h"
 #include "../../Misc/JammerClass.h"
 #include "../../Misc/PoweredUnitClass.h"
+#include "../../Misc/TechnoCounters.h"
 
 #include <AircraftClass.h>
 #include <GameOptionsClass.h>
@@ -203,6 +204,21 @@ DEFINE_HOOK(7014D5, TechnoClass_ChangeOwnership_RadarJammer, 6)
 	return 0;
 }
 
+// Radar Jammers (#305) only scan the radars and spy satellites on the map
+DEFINE_HOOK(440D01, BuildingClass_Put_RadarJammer, 6)
+{
+	GET(BuildingClass* const, pThis, ESI);
+	JammerClass::RegisterBuilding(pThis);
+	return 0;
+}
+
+DEFINE_HOOK(445DF4, BuildingClass_Remove_RadarJammer, 6)
+{
+	GET(BuildingClass* const, pThis, ESI);
+	JammerClass::UnregisterBuilding(pThis);
+	return 0;
+}
+
 // fix for vehicle paradrop alignment
 DEFINE_HOOK(415CA6, AircraftClass_Paradrop, 6)
 {
@@ -1099,6 +1115,7 @@ DEFINE_HOOK(74642C, UnitClass_ReceiveGunner, 6)
 	GET(UnitClass *, Unit, ESI);
 	auto pData = TechnoExt::ExtMap.Find(Unit);
 	pData->MyOriginalTemporal = Unit->TemporalImUsing;
+	TechnoExt::ExtMap.Watch(pData, pData->MyOriginalTemporal);
 	Unit->TemporalImUsing = nullptr;
 	return 0;
 }
@@ -1474,6 +1491,7 @@ DEFINE_HOOK(739F21, UnitClass_UpdatePosition_Visceroid, 6)
 					if(cellMe == cellHim) {
 						pDest->Type = pLargeType;
 						pDest->Health = pLargeType->Strength;
+						TechnoCounters::UpdateType(pDest);
 
 						CellClass* pCell = MapClass::Instance->GetCellAt(pDest->LastMapCoords);
 						pDest->UpdateThreatInCell(pCell);
@@ -261,6 +261,11 @@ public:
 		Valueable<bool> NoManualFire;
 		Valueable<bool> NoManualEnter;
 
+		// how many objects of this type exist, in total and per house
+		// ArrayIndex. not saved, see TechnoCounters
+		int LiveCount;
+		std::vector<int> OwnedCounts;
+
 		ExtData(TechnoTypeClass* OwnerObject) : Extension<TechnoTypeClass>(OwnerObject),
 			Survivors_PilotChance(-1),
 			Survivors_PassengerChance(-1),
@@ -366,7 +371,9 @@ public:
 			ImmuneToAbduction(false),
 			OmniCrusher_Aggressive(true),
 			ReloadAmount(1),
-			FactoryOwners_HaveAllPlans(false)
+			FactoryOwners_HaveAllPlans(false),
+			LiveCount(0),
+			OwnedCounts()
 		{ }
 
 		virtual ~ExtData() = default;
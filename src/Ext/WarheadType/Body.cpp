@@ -5,6 +5,7 @@
 #include "../Techno/Body.h"
 #include "../TechnoType/Body.h"
 #include "../../Misc/EMPulse.h"
+#include "../../Misc/TechnoCounters.h"
 #include "../../Utilities/TemplateDef.h"
 
 #include <WarheadTypeClass.h>
@@ -35,6 +36,11 @@ WarheadTypeClass * WarheadTypeExt::Temporal_WH = nullptr;
 
 WarheadTypeClass * WarheadTypeExt::EMP_WH = nullptr;
 
+std::vector<const WarheadTypeClass*> WarheadTypeExt::VersesTable::Warheads;
+std::vector<WarheadTypeExt::VersesData> WarheadTypeExt::VersesTable::Cells;
+size_t WarheadTypeExt::VersesTable::Columns = 0;
+bool WarheadTypeExt::VersesTable::Valid = false;
+
 void WarheadTypeExt::ExtData::Initialize() {
 	if(!_strcmpi(this->OwnerObject()->ID, "NUKE")) {
 		this->PreImpactAnim = AnimTypeClass::FindIndex("NUKEBALL");
@@ -53,6 +59,8 @@ void WarheadTypeExt::ExtData::LoadFromINIFile(CCINIClass* pINI)
 		return;
 	}
 
+	VersesTable::Invalidate();
+
 	// writing custom verses parser just because
 	if(pINI->ReadString(section, "Verses", "", Ares::readBuffer)) {
 		int idx = 0;
@@ -432,6 +440,7 @@ bool WarheadTypeExt::ExtData::applyKillDriver(
 
 			// remove the hijacker
 			pTarget->HijackerInfantryType = -1;
+			TechnoCounters::UpdateHijacked(pTarget);
 
 			// If this unit is driving under influence, we have to free it first
 			if(auto const pController = pTarget->MindControlledBy) {
@@ -564,6 +573,7 @@ void WarheadTypeExt::ExtData::Serialize(T& Stm) {
 void WarheadTypeExt::ExtData::LoadFromStream(AresStreamReader &Stm) {
 	Extension<WarheadTypeClass>::LoadFromStream(Stm);
 	this->Serialize(Stm);
+	VersesTable::Invalidate();
 }
 
 void WarheadTypeExt::ExtData::SaveToStream(AresStreamWriter &Stm) {
@@ -587,6 +597,95 @@ bool WarheadTypeExt::SaveGlobals(AresStreamWriter& Stm) {
 		.Success();
 }
 
+// =============================
+// verses table
+
+void WarheadTypeExt::VersesTable::Build() {
+	Columns = ArmorType::Array.size();
+	Warheads.clear();
+	Cells.clear();
+
+	for(auto const pWarhead : *WarheadTypeClass::Array) {
+		// finding the extension also repairs the slot if it is stale
+		auto const pExt = ExtMap.Find(pWarhead);
+		if(!pExt) {
+			continue;
+		}
+
+		auto const row = static_cast<size_t>(ContainerSlotBase::GetSlot(pWarhead));
+		if(row >= Warheads.size()) {
+			Warheads.resize(row + 1, nullptr);
+			Cells.resize((row + 1) * Columns);
+		}
+		Warheads[row] = pWarhead;
+
+		// armors the warhead did not read verses for use the armor's default,
+		// the same way ArmorType::LoadForWarhead resolves them
+		auto const pCells = &Cells[row * Columns];
+		auto const& verses = pExt->Verses;
+		for(size_t i = 0; i < Columns; ++i) {
+			if(i < static_cast<size_t>(verses.Count)) {
+				pCells[i] = verses.Items[i];
+			} else {
+				auto const& pArmor = ArmorType::Array[i];
+				auto const idx = pArmor->DefaultIndex;
+				pCells[i] = (idx >= 0 && static_cast<size_t>(idx) < i)
+					? pCells[idx]
+					: pArmor->DefaultVerses;
+			}
+		}
+	}
+
+	Valid = true;
+}
+
+const WarheadTypeExt::VersesData& WarheadTypeExt::VersesTable::GetUncached(
+	WarheadTypeClass const* const pWarhead, int const armor)
+{
+	static const VersesData Default;
+
+	if(auto const pExt = ExtMap.Find(pWarhead)) {
+		if(armor >= 0 && armor < pExt->Verses.Count) {
+			return pExt->Verses.Items[armor];
+		}
+	}
+
+	if(armor >= 0 && static_cast<size_t>(armor) < ArmorType::Array.size()) {
+		return ArmorType::Array[static_cast<size_t>(armor)]->DefaultVerses;
+	}
+
+	return Default;
+}
+
+bool WarheadTypeExt::VersesTable::WriteCSV(const char* const pFilename) {
+	FILE* F = nullptr;
+	if(fopen_s(&F, pFilename, "wt") || !F) {
+		return false;
+	}
+
+	fprintf(F, "Warhead");
+	for(auto const& pArmor : ArmorType::Array) {
+		fprintf(F, ",%s", pArmor->Name);
+	}
+	fprintf(F, "\n");
+
+	// cells list the verses in percent, followed by the flags that are off
+	for(auto const pWarhead : *WarheadTypeClass::Array) {
+		fprintf(F, "%s", pWarhead->ID);
+		for(size_t i = 0; i < ArmorType::Array.size(); ++i) {
+			auto const& cell = Get(pWarhead, static_cast<int>(i));
+			fprintf(F, ",%g%%%s%s%s", cell.Verses * 100.0,
+				cell.ForceFire ? "" : " -ForceFire",
+				cell.Retaliate ? "" : " -Retaliate",
+				cell.PassiveAcquire ? "" : " -PassiveAcquire");
+		}
+		fprintf(F, "\n");
+	}
+
+	fclose(F);
+	return true;
+}
+
 // =============================
 // container
 
@@ -607,6 +706,7 @@ DEFINE_HOOK(75D1A9, WarheadTypeClass_CTOR, 7)
 	GET(WarheadTypeClass*, pItem, EBP);
 
 	WarheadTypeExt::ExtMap.FindOrAllocate(pItem);
+	WarheadTypeExt::VersesTable::Invalidate();
 	return 0;
 }
 
@@ -615,6 +715,7 @@ DEFINE_HOOK(75E5C8, WarheadTypeClass_SDDTOR, 6)
 	GET(WarheadTypeClass*, pItem, ESI);
 
 	WarheadTypeExt::ExtMap.Remove(pItem);
+	WarheadTypeExt::VersesTable::Invalidate();
 	return 0;
 }
 
@@ -18,6 +18,8 @@
 #include "../../Misc/Debug.h"
 #endif
 
+#include <vector>
+
 class AnimTypeClass;
 class BulletClass;
 class HouseClass;
@@ -151,7 +153,7 @@ public:
 		void Serialize(T& Stm);
 	};
 
-	class ExtContainer final : public Container<WarheadTypeExt> {
+	class ExtContainer final : public Container<WarheadTypeExt, ContainerSlotMap> {
 	public:
 		ExtContainer();
 		~ExtContainer();
@@ -161,6 +163,43 @@ public:
 
 	static ExtContainer ExtMap;
 
+	// the verses of all warheads against all armors in one block, with the
+	// armor defaults already resolved. one row per warhead, in the order of
+	// the container's slots, so a lookup is one indexed load. rebuilt on the
+	// first lookup after any verses changed.
+	class VersesTable {
+	public:
+		static const VersesData& Get(WarheadTypeClass const* const pWarhead, int const armor) {
+			if(!Valid) {
+				Build();
+			}
+
+			auto const row = static_cast<size_t>(ContainerSlotBase::GetSlot(pWarhead));
+			auto const column = static_cast<size_t>(armor);
+			if(row < Warheads.size() && Warheads[row] == pWarhead && column < Columns) {
+				return Cells[row * Columns + column];
+			}
+
+			return GetUncached(pWarhead, armor);
+		}
+
+		static void Invalidate() {
+			Valid = false;
+		}
+
+		// writes one row per warhead and one column per armor
+		static bool WriteCSV(const char* pFilename);
+
+	private:
+		static void Build();
+		static const VersesData& GetUncached(WarheadTypeClass const* pWarhead, int armor);
+
+		static std::vector<const WarheadTypeClass*> Warheads;
+		static std::vector<VersesData> Cells;
+		static size_t Columns;
+		static bool Valid;
+	};
+
 	static bool LoadGlobals(AresStreamReader& Stm);
 	static bool SaveGlobals(AresStreamWriter& Stm);
 
@@ -7,6 +7,32 @@
 #include <Helpers\Enumerators.h>
 
 #include <algorithm>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace {
+	// every detonation needs an enumerator, and damaging objects can cause
+	// further detonations before the first one is done. keep the memory of
+	// finished enumerators around instead of freeing it.
+	std::vector<void*> EnumeratorPool;
+
+	CellSpreadEnumerator* AcquireEnumerator(size_t const spread) {
+		void* pMemory = nullptr;
+		if(EnumeratorPool.empty()) {
+			pMemory = ::operator new(sizeof(CellSpreadEnumerator));
+		} else {
+			pMemory = EnumeratorPool.back();
+			EnumeratorPool.pop_back();
+		}
+		return new(pMemory) CellSpreadEnumerator(spread);
+	}
+
+	void ReleaseEnumerator(CellSpreadEnumerator* const pIter) {
+		pIter->~CellSpreadEnumerator();
+		EnumeratorPool.push_back(pIter);
+	}
+}
 
 // create enumerator
 DEFINE_HOOK(4895B8, DamageArea_CellSpread1, 6) {
@@ -16,10 +42,15 @@ DEFINE_HOOK(4895B8, DamageArea_CellSpread1, 6) {
 	pIter = nullptr;
 
 	if(spread >= 0) {
-		pIter = new CellSpreadEnumerator(spread);
+		pIter = AcquireEnumerator(static_cast<size_t>(spread));
+
+		if(!*pIter) {
+			ReleaseEnumerator(pIter);
+			pIter = nullptr;
+		}
 	}
 
-	return (pIter && *pIter) ? 0x4895C3 : 0x4899DA;
+	return pIter ? 0x4895C3 : 0x4899DA;
 }
 
 // apply the current value
@@ -48,8 +79,9 @@ DEFINE_HOOK(4899BE, DamageArea_CellSpread3, 8)
 		return 0x4895C0;
 	}
 
-	// all done. delete and go on
-	delete pIter;
+	// all done. recycle and go on
+	ReleaseEnumerator(pIter);
+	pIter = nullptr;
 
 	return 0x4899DA;
 }
@@ -73,43 +105,113 @@ DEFINE_HOOK(4899DA, DamageArea_Damage_MaxAffect, 7)
 		return 0;
 	}
 
-	constexpr auto const DefaultSize = 1000;
-	ObjectClass* bufferHandled[DefaultSize];
-	DynamicVectorClass<ObjectClass*> handled(DefaultSize, bufferHandled);
-	handled.Reserve(groups.Count);
-
-	DamageGroup** bufferTarget[DefaultSize];
-	DynamicVectorClass<DamageGroup**> target(DefaultSize, bufferTarget);
-	target.Reserve(groups.Count);
-
-	for(auto& group : groups) {
-		// group could have been cleared by previous iteration.
-		// only handle if has not been handled already.
-		if(group && handled.AddUnique(group->Target)) {
-			target.Count = 0;
-
-			// collect all slots containing damage groups for this target
-			std::for_each(&group, groups.end(), [group, &target](DamageGroup* &item) {
-				if(item && item->Target == group->Target) {
-					target.AddItem(&item);
-				}
-			});
+	auto const limit = static_cast<ptrdiff_t>(MaxAffect);
+	auto const pEnd = groups.end();
+
+	// the first few targets are handled like the game does, by collecting
+	// the groups of each target from the rest of the list. that is quadratic
+	// in the number of targets, so beyond LinearTargets the remaining groups
+	// are sorted by target instead. see tools/cellspread for measurements.
+	// these are reused because the hook runs for every detonation.
+	static const size_t LinearTargets = 8;
+	static std::vector<ObjectClass*> handled;
+	static std::vector<DamageGroup**> target;
+	handled.clear();
+
+	auto const IsHandled = [](ObjectClass* const pTarget) {
+		return std::find(handled.begin(), handled.end(), pTarget) != handled.end();
+	};
+
+	auto pRest = pEnd;
+	for(auto pGroup = groups.begin(); pGroup != pEnd; ++pGroup) {
+		auto const group = *pGroup;
+		if(!group || IsHandled(group->Target)) {
+			continue;
+		}
+
+		if(handled.size() == LinearTargets) {
+			pRest = pGroup;
+			break;
+		}
+
+		handled.push_back(group->Target);
+		target.clear();
 
-			// if more than allowed, sort them and remove the ones further away
-			if(target.Count > MaxAffect) {
-				Helpers::Alex::selectionsort(
-					target.begin(), target.begin() + MaxAffect, target.end(),
-					[](DamageGroup** a, DamageGroup** b)
-				{
-					return (*a)->Distance < (*b)->Distance;
-				});
-
-				std::for_each(target.begin() + MaxAffect, target.end(), [](DamageGroup** ppItem) {
-					GameDelete(*ppItem);
-					*ppItem = nullptr;
-				});
+		// collect all slots containing damage groups for this target
+		for(auto pItem = pGroup; pItem != pEnd; ++pItem) {
+			if(*pItem && (*pItem)->Target == group->Target) {
+				target.push_back(pItem);
 			}
 		}
+
+		// if more than allowed, sort them and remove the ones further away
+		if(static_cast<ptrdiff_t>(target.size()) > limit) {
+			auto const cutoff = target.begin() + limit;
+			Helpers::Alex::selectionsort(target.begin(), cutoff, target.end(),
+				[](DamageGroup** a, DamageGroup** b)
+			{
+				return (*a)->Distance < (*b)->Distance;
+			});
+
+			std::for_each(cutoff, target.end(), [](DamageGroup** ppItem) {
+				GameDelete(*ppItem);
+				*ppItem = nullptr;
+			});
+		}
+	}
+
+	// pair each remaining damage group slot with its target, then sort, so
+	// all groups hitting the same target are next to each other. targets are
+	// ordered by their id and groups by their slot, which is the order the
+	// cells were scanned in, so the result does not depend on where objects
+	// are allocated. the handled targets have been dealt with already.
+	using Item = std::pair<ObjectClass*, DamageGroup**>;
+	static std::vector<Item> targets;
+	targets.clear();
+
+	for(auto pGroup = pRest; pGroup != pEnd; ++pGroup) {
+		if(*pGroup && !IsHandled((*pGroup)->Target)) {
+			targets.emplace_back((*pGroup)->Target, pGroup);
+		}
+	}
+
+	std::sort(targets.begin(), targets.end(), [](
+		Item const& lhs, Item const& rhs)
+	{
+		auto const lhsID = lhs.first->UniqueID;
+		auto const rhsID = rhs.first->UniqueID;
+		if(lhsID != rhsID) {
+			return lhsID < rhsID;
+		}
+		return lhs.second < rhs.second;
+	});
+
+	for(auto it = targets.begin(); it != targets.end();) {
+		auto const pTarget = it->first;
+		auto const last = std::find_if(it, targets.end(), [pTarget](
+			Item const& item)
+		{
+			return item.first != pTarget;
+		});
+
+		// the groups are still in scan order here, and selecting them like
+		// this keeps the same ones as the linear pass on equal distances
+		if(std::distance(it, last) > limit) {
+			auto const cutoff = it + limit;
+			Helpers::Alex::selectionsort(it, cutoff, last, [](
+				Item const& lhs, Item const& rhs)
+			{
+				return (*lhs.second)->Distance < (*rhs.second)->Distance;
+			});
+
+			std::for_each(cutoff, last, [](Item const& item)
+			{
+				GameDelete(*item.second);
+				*item.second = nullptr;
+			});
+		}
+
+		it = last;
 	}
 
 	// move all the empty ones to the back, then remove them
@@ -3,8 +3,7 @@
 #define GET_VERSES(reg_wh, reg_armor) \
 	GET(WarheadTypeClass *, WH, reg_wh); \
 	GET(int, Armor, reg_armor); \
-	WarheadTypeExt::ExtData *pData = WarheadTypeExt::ExtMap.Find(WH); \
-	WarheadTypeExt::VersesData *vsData = &pData->Verses[Armor];
+	auto const vsData = &WarheadTypeExt::VersesTable::Get(WH, Armor);
 
 #define FLD_VERSES(reg_wh, reg_armor) \
 	GET_VERSES(reg_wh, reg_armor) \
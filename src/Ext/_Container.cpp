@@ -1,5 +1,8 @@
 #include "_Container.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 ContainerMapBase::ContainerMapBase() = default;
 ContainerMapBase::~ContainerMapBase() = default;
 
@@ -36,3 +39,339 @@ void ContainerMapBase::clear()
 	// this leaks all objects inside. this case is logged.
 	this->Items.clear();
 }
+
+ContainerSlotBase::ContainerSlotBase() = default;
+ContainerSlotBase::~ContainerSlotBase() = default;
+
+size_t ContainerSlotBase::lookup(ContainerSlotBase::const_key_type key) const
+{
+	if(!key) {
+		return this->Items.size();
+	}
+
+	// the owner object knows where its value is. insert and remove keep all
+	// slots of objects in here up to date, and objects loaded from a save
+	// game are inserted after their memory has been read. so any other slot
+	// value means the object is not in here, and there is nothing to search.
+	auto const slot = Slot(key);
+	if(slot < this->Items.size() && this->Items[slot].first == key) {
+		return slot;
+	}
+
+	return this->Items.size();
+}
+
+ContainerSlotBase::value_type ContainerSlotBase::find(
+	ContainerSlotBase::const_key_type key) const
+{
+	auto const idx = this->lookup(key);
+	if(idx < this->Items.size()) {
+		return this->Items[idx].second;
+	}
+	return nullptr;
+}
+
+void ContainerSlotBase::insert(
+	ContainerSlotBase::const_key_type key, ContainerSlotBase::value_type value)
+{
+	Slot(key) = this->Items.size();
+	this->Items.emplace_back(key, value);
+}
+
+ContainerSlotBase::value_type ContainerSlotBase::remove(
+	ContainerSlotBase::const_key_type key)
+{
+	auto const idx = this->lookup(key);
+	if(idx < this->Items.size()) {
+		auto const value = this->Items[idx].second;
+
+		// move the last item into the gap and tell its owner
+		if(idx + 1 < this->Items.size()) {
+			this->Items[idx] = this->Items.back();
+			Slot(this->Items[idx].first) = idx;
+		}
+		this->Items.pop_back();
+
+		return value;
+	}
+	return nullptr;
+}
+
+void ContainerSlotBase::clear()
+{
+	// this leaks all objects inside. this case is logged.
+	this->Items.clear();
+}
+
+ContainerPoolBase::ContainerPoolBase(size_t const blockSize) :
+	// blocks have to be able to hold the free list link, and the alignment
+	// has to be good enough for doubles
+	BlockSize((std::max(blockSize, sizeof(void*)) + 7u) & ~7u),
+	FreeList(nullptr),
+	LiveCount(0),
+	FreeCount(0),
+	Allocations(0),
+	PeakCount(0),
+	Slabs()
+{ }
+
+ContainerPoolBase::~ContainerPoolBase() = default;
+
+void ContainerPoolBase::grow()
+{
+	auto const size = this->BlockSize * BlocksPerSlab;
+	this->Slabs.emplace_back(new char[size]);
+	auto const pSlab = this->Slabs.back().get();
+
+	// link the new blocks in reverse, so they are handed out in order
+	for(auto i = BlocksPerSlab; i > 0; --i) {
+		auto const pBlock = pSlab + (i - 1) * this->BlockSize;
+		*reinterpret_cast<void**>(pBlock) = this->FreeList;
+		this->FreeList = pBlock;
+	}
+
+	this->FreeCount += BlocksPerSlab;
+}
+
+void* ContainerPoolBase::allocate()
+{
+	if(!this->FreeList) {
+		this->grow();
+	}
+
+	auto const ret = this->FreeList;
+	this->FreeList = *static_cast<void**>(ret);
+
+	--this->FreeCount;
+	++this->LiveCount;
+	++this->Allocations;
+	this->PeakCount = std::max(this->PeakCount, this->LiveCount);
+	return ret;
+}
+
+void ContainerPoolBase::deallocate(void* const ptr)
+{
+	*static_cast<void**>(ptr) = this->FreeList;
+	this->FreeList = ptr;
+
+	--this->LiveCount;
+	++this->FreeCount;
+}
+
+bool ContainerPoolBase::release()
+{
+	if(this->LiveCount) {
+		return false;
+	}
+
+	this->Slabs.clear();
+	this->FreeList = nullptr;
+	this->FreeCount = 0;
+	this->Allocations = 0;
+	this->PeakCount = 0;
+	return true;
+}
+
+ContainerWatcherBase::ContainerWatcherBase() = default;
+ContainerWatcherBase::~ContainerWatcherBase() = default;
+
+// removes one occurrence of item, not preserving the order
+template <typename T>
+static void EraseUnordered(std::vector<T>& items, T const item)
+{
+	auto const it = std::find(items.begin(), items.end(), item);
+	if(it != items.end()) {
+		*it = items.back();
+		items.pop_back();
+	}
+}
+
+void ContainerWatcherBase::watch(
+	ContainerWatcherBase::target_type const target,
+	ContainerWatcherBase::watcher_type const watcher)
+{
+	auto& watchers = this->Watchers[target];
+	if(std::find(watchers.begin(), watchers.end(), watcher) == watchers.end()) {
+		watchers.push_back(watcher);
+		this->Targets[watcher].push_back(target);
+	}
+}
+
+void ContainerWatcherBase::unwatch(
+	ContainerWatcherBase::watcher_type const watcher)
+{
+	auto const it = this->Targets.find(watcher);
+	if(it != this->Targets.end()) {
+		for(auto const target : it->second) {
+			auto const watchers = this->Watchers.find(target);
+			if(watchers != this->Watchers.end()) {
+				EraseUnordered(watchers->second, watcher);
+				if(watchers->second.empty()) {
+					this->Watchers.erase(watchers);
+				}
+			}
+		}
+		this->Targets.erase(it);
+	}
+}
+
+std::vector<ContainerWatcherBase::watcher_type> ContainerWatcherBase::expire(
+	ContainerWatcherBase::target_type const target)
+{
+	std::vector<watcher_type> ret;
+
+	auto const it = this->Watchers.find(target);
+	if(it != this->Watchers.end()) {
+		ret = std::move(it->second);
+		this->Watchers.erase(it);
+
+		for(auto const watcher : ret) {
+			auto const targets = this->Targets.find(watcher);
+			if(targets != this->Targets.end()) {
+				EraseUnordered(targets->second, target);
+				if(targets->second.empty()) {
+					this->Targets.erase(targets);
+				}
+			}
+		}
+	}
+
+	return ret;
+}
+
+void ContainerWatcherBase::clear()
+{
+	this->Watchers.clear();
+	this->Targets.clear();
+}
+
+ContainerBlockStore ContainerBlockStore::Instance;
+
+ContainerBlockStore::ContainerBlockStore() :
+	Data(0),
+	Lengths(),
+	Pending(),
+	BlockStart(0),
+	CurrentBlock(0),
+	CurrentOffset(0)
+{ }
+
+ContainerBlockStore::~ContainerBlockStore() = default;
+
+AresByteStream& ContainerBlockStore::BeginBlock()
+{
+	this->BlockStart = this->Data.Size();
+	return this->Data;
+}
+
+void ContainerBlockStore::EndBlock()
+{
+	this->Lengths.push_back(this->Data.Size() - this->BlockStart);
+}
+
+bool ContainerBlockStore::WriteToStream(IStream* const pStm)
+{
+	// the table goes behind the data, so everything is a single block
+	auto const count = this->Lengths.size();
+	auto const size = this->Data.Size();
+
+	if(count) {
+		this->Data.Write(reinterpret_cast<const AresByteStream::data_t*>(
+			this->Lengths.data()), count * sizeof(size_t));
+	}
+	this->Data.Save(count);
+
+	Debug::Log("[ContainerBlockStore] Writing %u blocks, 0x%X bytes\n",
+		count, size);
+
+	return this->Data.WriteBlockToStream(pStm);
+}
+
+void ContainerBlockStore::Defer(Loader* const pLoader, void* const key)
+{
+	this->Pending.emplace_back(pLoader, key);
+}
+
+bool ContainerBlockStore::ReadFromStream(IStream* const pStm)
+{
+	this->Data.Reset();
+	this->Lengths.clear();
+	this->CurrentBlock = 0;
+	this->CurrentOffset = 0;
+
+	auto const length = this->Data.ReadBlockFromStream(pStm);
+	if(length < sizeof(size_t)) {
+		Debug::Log("[ContainerBlockStore] Could not read blocks.\n");
+		return false;
+	}
+
+	// read the table from the end of the block
+	size_t count = 0;
+	auto const countPos = length - sizeof(size_t);
+	std::memcpy(&count, this->Data.Raw() + countPos, sizeof(size_t));
+
+	if(count > countPos / sizeof(size_t)) {
+		Debug::Log("[ContainerBlockStore] Block table is corrupt.\n");
+		return false;
+	}
+
+	auto const tablePos = countPos - count * sizeof(size_t);
+	this->Lengths.resize(count);
+	if(count) {
+		std::memcpy(this->Lengths.data(), this->Data.Raw() + tablePos,
+			count * sizeof(size_t));
+	}
+
+	size_t total = 0;
+	for(auto const& len : this->Lengths) {
+		total += len;
+	}
+
+	if(total != tablePos) {
+		Debug::Log("[ContainerBlockStore] Block table does not match data: "
+			"0x%X vs 0x%X bytes.\n", total, tablePos);
+		return false;
+	}
+
+	if(count != this->Pending.size()) {
+		Debug::Log("[ContainerBlockStore] Read %u blocks, but %u objects "
+			"were loaded.\n", count, this->Pending.size());
+		return false;
+	}
+
+	Debug::Log("[ContainerBlockStore] Loading %u blocks, 0x%X bytes\n",
+		count, tablePos);
+
+	// let every container parse its block in save order
+	for(auto const& item : this->Pending) {
+		if(!item.first->LoadBlock(item.second, pStm)) {
+			Debug::FatalErrorAndExit("[ContainerBlockStore] Loading failed!\n");
+		}
+	}
+
+	return true;
+}
+
+bool ContainerBlockStore::NextBlock(AresByteStream& Stm)
+{
+	if(this->CurrentBlock >= this->Lengths.size()) {
+		return false;
+	}
+
+	auto const length = this->Lengths[this->CurrentBlock++];
+	Stm.Write(this->Data.Raw() + this->CurrentOffset, length);
+	this->CurrentOffset += length;
+
+	return true;
+}
+
+void ContainerBlockStore::Clear()
+{
+	// give the memory back, this can be a lot
+	AresByteStream(0).swap(this->Data);
+	std::vector<size_t>().swap(this->Lengths);
+	std::vector<std::pair<Loader*, void*>>().swap(this->Pending);
+	this->BlockStart = 0;
+	this->CurrentBlock = 0;
+	this->CurrentOffset = 0;
+}
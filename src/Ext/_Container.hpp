@@ -1,6 +1,8 @@
 #pragma once
 
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include <CCINIClass.h>
 #include <SwizzleManagerClass.h>
@@ -46,6 +48,14 @@ enum class InitState {
    	class TX::ExtData : public Extension<T> { custom_data; }
 
    Complex? Yes. That's partially why you should be happy these are premade for you.
+
+ * ==========================
+
+   By default, Container<TX> finds the ExtData through a hash map. Containers
+   that are queried in hot paths can use Container<TX, ContainerSlotMap>
+   instead, which keeps the ExtData in a dense array and makes the owner
+   object remember its position. Only one container per object may do this,
+   as there is only one spare slot in AbstractClass.
  *
  */
 
@@ -223,27 +233,297 @@ private:
 	ContainerMapBase Items;
 };
 
-template<typename T>
-class Container {
+// a non-virtual base class for a dense pointer to pointer storage. each owner
+// object stores the index of its value in the unused dword at SlotOffset, so
+// finding a value is an indexed load instead of a hash lookup.
+// pointers are not owned by this storage, so be cautious.
+class ContainerSlotBase final {
+public:
+	using key_type = void*;
+	using const_key_type = const void*;
+	using value_type = void*;
+	using entry_type = std::pair<const_key_type, value_type>;
+	using vector_type = std::vector<entry_type>;
+	using const_iterator = vector_type::const_iterator;
+	using iterator = const_iterator;
+
+	// AbstractClass::unknown_18, never used by the game itself
+	static const size_t SlotOffset = 0x18;
+
+	ContainerSlotBase();
+	ContainerSlotBase(ContainerSlotBase const&) = delete;
+	~ContainerSlotBase();
+
+	ContainerSlotBase& operator =(ContainerSlotBase const&) = delete;
+	ContainerSlotBase& operator =(ContainerSlotBase&&) = delete;
+
+	value_type find(const_key_type key) const;
+	void insert(const_key_type key, value_type value);
+	value_type remove(const_key_type key);
+	void clear();
+
+	size_t size() const {
+		return this->Items.size();
+	}
+
+	const_iterator begin() const {
+		return this->Items.cbegin();
+	}
+
+	const_iterator end() const {
+		return this->Items.cend();
+	}
+
+	// the position the owner object remembers. objects not in here can have
+	// any value, so check the key at that position before relying on it.
+	static DWORD GetSlot(const_key_type key) {
+		return Slot(key);
+	}
+
+private:
+	static DWORD& Slot(const_key_type key) {
+		return *reinterpret_cast<DWORD*>(
+			reinterpret_cast<uintptr_t>(key) + SlotOffset);
+	}
+
+	size_t lookup(const_key_type key) const;
+
+	vector_type Items;
+};
+
+// the typed counterpart of ContainerMap for the slot storage. Key has to be
+// derived from AbstractClass, as that is where the slot lives.
+template<typename Key, typename Value>
+class ContainerSlotMap final {
+public:
+	using key_type = Key*;
+	using const_key_type = const Key*;
+	using value_type = Value*;
+	using iterator = typename std::vector<std::pair<key_type, value_type>>::const_iterator;
+
+	ContainerSlotMap() = default;
+	ContainerSlotMap(ContainerSlotMap const&) = delete;
+
+	ContainerSlotMap& operator =(ContainerSlotMap const&) = delete;
+	ContainerSlotMap& operator =(ContainerSlotMap&&) = delete;
+
+	value_type find(const_key_type key) const {
+		return static_cast<value_type>(this->Items.find(key));
+	}
+
+	value_type insert(const_key_type key, value_type value) {
+		this->Items.insert(key, value);
+		return value;
+	}
+
+	value_type remove(const_key_type key) {
+		return static_cast<value_type>(this->Items.remove(key));
+	}
+
+	void clear() {
+		this->Items.clear();
+	}
+
+	size_t size() const {
+		return this->Items.size();
+	}
+
+	iterator begin() const {
+		auto ret = this->Items.begin();
+		return reinterpret_cast<iterator&>(ret);
+	}
+
+	iterator end() const {
+		auto ret = this->Items.end();
+		return reinterpret_cast<iterator&>(ret);
+	}
+
+private:
+	ContainerSlotBase Items;
+};
+
+// a non-virtual fixed-size block allocator. memory is requested from the heap
+// in slabs of BlocksPerSlab blocks, and freed blocks are kept in a free list
+// to be handed out again. slabs are only given back as a whole.
+class ContainerPoolBase final {
+public:
+	static const size_t BlocksPerSlab = 256;
+
+	explicit ContainerPoolBase(size_t blockSize);
+	ContainerPoolBase(ContainerPoolBase const&) = delete;
+	~ContainerPoolBase();
+
+	ContainerPoolBase& operator =(ContainerPoolBase const&) = delete;
+	ContainerPoolBase& operator =(ContainerPoolBase&&) = delete;
+
+	void* allocate();
+	void deallocate(void* ptr);
+
+	// frees all slabs. fails if there are still blocks in use.
+	bool release();
+
+	size_t live() const {
+		return this->LiveCount;
+	}
+
+	size_t free() const {
+		return this->FreeCount;
+	}
+
+	size_t slabs() const {
+		return this->Slabs.size();
+	}
+
+	// since the last release: blocks handed out, and the most alive at once
+	size_t allocations() const {
+		return this->Allocations;
+	}
+
+	size_t peak() const {
+		return this->PeakCount;
+	}
+
+private:
+	void grow();
+
+	size_t BlockSize;
+	void* FreeList;
+	size_t LiveCount;
+	size_t FreeCount;
+	size_t Allocations;
+	size_t PeakCount;
+	std::vector<std::unique_ptr<char[]>> Slabs;
+};
+
+// a non-virtual registry of which watcher holds a pointer to which target, so
+// expiring pointers only need to be announced to the watchers holding them.
+// registrations are allowed to be stale, watchers have to check the pointer.
+class ContainerWatcherBase final {
+public:
+	using target_type = const void*;
+	using watcher_type = void*;
+
+	ContainerWatcherBase();
+	ContainerWatcherBase(ContainerWatcherBase const&) = delete;
+	~ContainerWatcherBase();
+
+	ContainerWatcherBase& operator =(ContainerWatcherBase const&) = delete;
+	ContainerWatcherBase& operator =(ContainerWatcherBase&&) = delete;
+
+	void watch(target_type target, watcher_type watcher);
+
+	// forgets everything watcher has registered for
+	void unwatch(watcher_type watcher);
+
+	// forgets target and returns everyone who watched it
+	std::vector<watcher_type> expire(target_type target);
+
+	void clear();
+
+	size_t size() const {
+		return this->Watchers.size();
+	}
+
+private:
+	// target to the watchers holding a pointer to it, and the reverse
+	std::unordered_map<target_type, std::vector<watcher_type>> Watchers;
+	std::unordered_map<watcher_type, std::vector<target_type>> Targets;
+};
+
+// collects the extension blocks of all containers while the game is saved, so
+// they can be written in one go after all game objects instead of with two
+// stream calls per object. loading reads the whole region back at once, then
+// lets each container parse its blocks in the order they were saved.
+class ContainerBlockStore final {
+public:
+	// a container that has to be called back once its block is available
+	class Loader {
+	public:
+		virtual bool LoadBlock(void* key, IStream* pStm) = 0;
+
+	protected:
+		~Loader() = default;
+	};
+
+	static ContainerBlockStore Instance;
+
+	ContainerBlockStore();
+	ContainerBlockStore(ContainerBlockStore const&) = delete;
+	~ContainerBlockStore();
+
+	ContainerBlockStore& operator =(ContainerBlockStore const&) = delete;
+	ContainerBlockStore& operator =(ContainerBlockStore&&) = delete;
+
+	// returns the stream the next block is to be written to
+	AresByteStream& BeginBlock();
+
+	// ends the block started by the last call to BeginBlock
+	void EndBlock();
+
+	// writes all blocks and the offset table
+	bool WriteToStream(IStream* pStm);
+
+	// remembers that the block of key has to be loaded by pLoader
+	void Defer(Loader* pLoader, void* key);
+
+	// reads all blocks and the offset table, then calls all deferred loaders
+	bool ReadFromStream(IStream* pStm);
+
+	// copies the next unread block into Stm
+	bool NextBlock(AresByteStream& Stm);
+
+	// whether objects have been loaded whose extension is not read yet
+	bool IsLoading() const {
+		return !this->Pending.empty();
+	}
+
+	void Clear();
+
+private:
+	AresByteStream Data;
+	std::vector<size_t> Lengths;
+	std::vector<std::pair<Loader*, void*>> Pending;
+	size_t BlockStart;
+	size_t CurrentBlock;
+	size_t CurrentOffset;
+};
+
+template<typename T, template<typename, typename> class TMap = ContainerMap>
+class Container : public ContainerBlockStore::Loader {
 private:
 	using base_type = typename T::base_type;
 	using extension_type = typename T::ExtData;
 	using key_type = base_type*;
 	using const_key_type = const base_type*;
 	using value_type = extension_type*;
-	using map_type = ContainerMap<base_type, extension_type>;
+	using map_type = TMap<base_type, extension_type>;
 
 	map_type Items;
+	ContainerPoolBase Pool;
 
 	base_type* SavingObject;
 	IStream* SavingStream;
 	const char* Name;
 
+	// scratch storage reused by every LoadKey call, so it only grows until
+	// it fits the largest block
+	AresByteStream Buffer;
+
+	// which extension holds which pointer, if UsesWatchers is true. the
+	// pointers are not valid before the load completed, so loading marks
+	// the registry dirty and it is rebuilt when it is needed next.
+	ContainerWatcherBase Watchers;
+	bool WatchersDirty;
+
 public:
 	explicit Container(const char* pName) : Items(),
+		Pool(sizeof(extension_type)),
 		SavingObject(nullptr),
 		SavingStream(nullptr),
-		Name(pName)
+		Name(pName),
+		Buffer(0),
+		Watchers(),
+		WatchersDirty(false)
 	{ }
 
 	virtual ~Container() = default;
@@ -255,6 +535,14 @@ public:
 		}
 	}
 
+	// remembers that pExt holds a pointer to pTarget. only used if the
+	// container overrides UsesWatchers.
+	void Watch(value_type pExt, const void* pTarget) {
+		if(pExt && pTarget) {
+			this->Watchers.watch(pTarget, pExt);
+		}
+	}
+
 protected:
 	virtual void InvalidatePointer(void *ptr, bool bRemoved) {
 	}
@@ -263,7 +551,32 @@ protected:
 		return true;
 	}
 
+	// return true to announce expiring pointers only to the extensions
+	// that registered via Watch, instead of to all of them. the container
+	// then has to register all pointers of an extension in WatchAll.
+	virtual bool UsesWatchers() const {
+		return false;
+	}
+
+	virtual void WatchAll(value_type pExt) {
+	}
+
 	void InvalidateExtDataPointer(void *ptr, bool bRemoved) {
+		if(this->UsesWatchers()) {
+			if(this->WatchersDirty) {
+				this->Watchers.clear();
+				for(const auto& i : this->Items) {
+					this->WatchAll(i.second);
+				}
+				this->WatchersDirty = false;
+			}
+
+			for(auto const pWatcher : this->Watchers.expire(ptr)) {
+				static_cast<value_type>(pWatcher)->InvalidatePointer(ptr, bRemoved);
+			}
+			return;
+		}
+
 		for(const auto& i : this->Items) {
 			i.second->InvalidatePointer(ptr, bRemoved);
 		}
@@ -278,17 +591,29 @@ public:
 		if(auto const ptr = this->Items.find(key)) {
 			return ptr;
 		}
-		auto val = new extension_type(key);
+		auto val = new(this->Pool.allocate()) extension_type(key);
 		val->EnsureConstanted();
 		return this->Items.insert(key, val);
 	}
 
+	// objects loaded from a savegame get their extension only after all game
+	// objects are loaded (Ares::LoadGameData), so this returns null for them
+	// in hooks that run from inside the game's Load functions
 	value_type Find(const_key_type key) const {
-		return this->Items.find(key);
+		auto const ret = this->Items.find(key);
+		if(!ret && key && ContainerBlockStore::Instance.IsLoading()) {
+			Debug::Log("[Find] Extension of %p as '%s' requested before "
+				"it was loaded.\n", key, this->Name);
+		}
+		return ret;
 	}
 
 	void Remove(const_key_type key) {
-		delete this->Items.remove(key);
+		if(auto const ptr = this->Items.remove(key)) {
+			this->Watchers.unwatch(ptr);
+			ptr->~extension_type();
+			this->Pool.deallocate(ptr);
+		}
 	}
 
 	void Clear() {
@@ -297,6 +622,23 @@ public:
 				this->Items.size(), this->Name);
 			this->Items.clear();
 		}
+
+		this->Watchers.clear();
+		this->WatchersDirty = false;
+
+		auto const slabs = this->Pool.slabs();
+		if(auto const allocations = this->Pool.allocations()) {
+			Debug::Log("%s pool: %u allocations, %u reused, at most %u alive in %u slabs.\n",
+				this->Name, allocations, allocations - this->Pool.peak(),
+				this->Pool.peak(), slabs);
+		}
+
+		// leaked items might still be referenced, so keep their memory
+		if(!this->Pool.release()) {
+			Debug::Log(Debug::Severity::Warning,
+				"Kept %u pool slabs of %s, %u blocks are still alive.\n",
+				slabs, this->Name, this->Pool.live());
+		}
 	}
 
 	void LoadAllFromINI(CCINIClass *pINI) {
@@ -334,13 +676,13 @@ public:
 		this->SavingStream = nullptr;
 	}
 
+	// the block is read after all game objects have been loaded, see LoadBlock.
+	// until then, Find returns null for this object
 	void LoadStatic() {
 		if(this->SavingObject && this->SavingStream) {
-			Debug::Log("[LoadStatic] Loading object %p as '%s'\n", this->SavingObject, this->Name);
+			Debug::Log("[LoadStatic] Deferring object %p as '%s'\n", this->SavingObject, this->Name);
 
-			if(!this->Load(this->SavingObject, this->SavingStream)) {
-				Debug::FatalErrorAndExit("[LoadStatic] Loading failed!\n");
-			}
+			ContainerBlockStore::Instance.Defer(this, this->SavingObject);
 		} else {
 			Debug::Log("[LoadStatic] Object or Stream not set for '%s': %p, %p\n",
 				this->Name, this->SavingObject, this->SavingStream);
@@ -350,6 +692,13 @@ public:
 		this->SavingStream = nullptr;
 	}
 
+	virtual bool LoadBlock(void* key, IStream* pStm) override {
+		auto const pKey = static_cast<key_type>(key);
+		Debug::Log("[LoadBlock] Loading object %p as '%s'\n", pKey, this->Name);
+
+		return this->Load(pKey, pStm);
+	}
+
 protected:
 	// override this method to do type-specific stuff
 	virtual bool Save(key_type key, IStream *pStm) {
@@ -375,8 +724,11 @@ protected:
 			return nullptr;
 		}
 
-		// write the current pointer, the size of the block, and the canary
-		AresByteStream saver(sizeof(*buffer));
+		// write the current pointer, the size of the block, and the canary.
+		// the block store writes it to pStm together with all other blocks
+		auto& store = ContainerBlockStore::Instance;
+		auto& saver = store.BeginBlock();
+		auto const start = saver.Size();
 		AresStreamWriter writer(saver);
 
 		writer.Save(extension_type::Canary);
@@ -386,12 +738,9 @@ protected:
 		buffer->SaveToStream(writer);
 
 		// save the block
-		if(!saver.WriteBlockToStream(pStm)) {
-			Debug::Log("[SaveKey] Failed to save data.\n");
-			return nullptr;
-		}
+		store.EndBlock();
 
-		Debug::Log("[SaveKey] Save used up 0x%X bytes\n", saver.Size());
+		Debug::Log("[SaveKey] Save used up 0x%X bytes\n", saver.Size() - start);
 
 		// done
 		return buffer;
@@ -411,12 +760,16 @@ protected:
 			return nullptr;
 		}
 
-		AresByteStream loader(0);
-		if(!loader.ReadBlockFromStream(pStm)) {
+		auto& loader = this->Buffer;
+		loader.Reset();
+		if(!ContainerBlockStore::Instance.NextBlock(loader)) {
 			Debug::Log("[LoadKey] Failed to read data from save stream?!\n");
 			return nullptr;
 		}
 
+		// the loaded pointers are converted later
+		this->WatchersDirty = true;
+
 		AresStreamReader reader(loader);
 		if(reader.Expect(extension_type::Canary) && reader.RegisterChange(buffer)) {
 			buffer->LoadFromStream(reader);
@@ -140,6 +140,7 @@ void AttachEffectTypeClass::Attach(
 	auto& Attaching = Effects.back();
 
 	Attaching.Invoker = pInvoker;
+	TechnoExt::ExtMap.Watch(pTargetExt, pInvoker);
 
 	// update the unit with the attached effect
 	pTargetExt->RecalculateStats();
@@ -202,6 +203,10 @@ void AttachEffectClass::CreateAnim(TechnoClass* pOwner) {
 			pAnim->SetOwnerObject(pOwner);
 			pAnim->RemainingIterations = 0xFFu;
 
+			// the anim might expire on its own
+			auto const pOwnerExt = TechnoExt::ExtMap.Find(pOwner);
+			TechnoExt::ExtMap.Watch(pOwnerExt, pAnim);
+
 			if(this->Invoker && this->Invoker->Owner) {
 				pAnim->Owner = this->Invoker->Owner;
 			}
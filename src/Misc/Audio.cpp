@@ -5,6 +5,94 @@
 #include <VocClass.h>
 #include "../Ares.h"
 #include "../Ares.CRT.h"
+#include "../Utilities/Stopwatch.h"
+
+#include <algorithm>
+#include <cctype>
+#include <numeric>
+
+namespace {
+	// the contents of a file, mapped into memory if it is a loose file, or
+	// read in one go if it is inside a mix file.
+	class FileView {
+	public:
+		explicit FileView(const char* pFilename) {
+			auto const hFile = CreateFileA(pFilename, GENERIC_READ,
+				FILE_SHARE_READ, nullptr, OPEN_EXISTING, 0, nullptr);
+
+			if(hFile != INVALID_HANDLE_VALUE) {
+				LARGE_INTEGER size;
+				if(GetFileSizeEx(hFile, &size) && size.QuadPart > 0) {
+					this->Mapping = CreateFileMappingA(
+						hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+					if(this->Mapping) {
+						this->View = MapViewOfFile(
+							this->Mapping, FILE_MAP_READ, 0, 0, 0);
+						this->Size = static_cast<size_t>(size.QuadPart);
+					}
+				}
+				CloseHandle(hFile);
+			}
+
+			if(this->View) {
+				this->Data = static_cast<const char*>(this->View);
+				this->Mapped = true;
+				return;
+			}
+
+			// not a loose file, let the game find it
+			auto const pFile = GameCreate<CCFileClass>(pFilename);
+			if(pFile->Exists() && pFile->Open(FileAccessMode::Read)) {
+				auto const size = pFile->GetFileSize();
+				if(size > 0) {
+					this->Buffer.resize(static_cast<size_t>(size));
+					if(pFile->ReadBytes(this->Buffer.data(), size) == size) {
+						this->Data = this->Buffer.data();
+						this->Size = this->Buffer.size();
+					}
+				}
+			}
+			GameDelete(pFile);
+		}
+
+		~FileView() {
+			if(this->View) {
+				UnmapViewOfFile(this->View);
+			}
+			if(this->Mapping) {
+				CloseHandle(this->Mapping);
+			}
+		}
+
+		FileView(const FileView&) = delete;
+		FileView& operator = (const FileView&) = delete;
+
+		bool IsMapped() const {
+			return this->Mapped;
+		}
+
+		// copies count objects from offset, if the file is large enough
+		template <typename T>
+		bool Read(size_t const offset, T* pBuffer, size_t const size) const {
+			if(!this->Data || offset > this->Size || size > this->Size - offset) {
+				return false;
+			}
+			memcpy(pBuffer, this->Data + offset, size);
+			return true;
+		}
+
+	private:
+		HANDLE Mapping{ nullptr };
+		void* View{ nullptr };
+		std::vector<char> Buffer;
+		const char* Data{ nullptr };
+		size_t Size{ 0 };
+		bool Mapped{ false };
+	};
+
+	unsigned int MappedIndexes = 0;
+}
 
 LooseAudioCache LooseAudioCache::Instance;
 AudioLuggage AudioLuggage::Instance;
@@ -59,69 +147,186 @@ void AudioBag::Open(const char* fileBase) {
 	char filename[0x100];
 	_snprintf_s(filename, _TRUNCATE, "%s.idx", fileBase);
 
-	auto pIndex = UniqueGamePtr<CCFileClass>(GameCreate<CCFileClass>(filename));
+	// the whole index is parsed from memory
+	FileView index(filename);
 
-	if(pIndex->Exists() && pIndex->Open(FileAccessMode::Read)) {
-		_snprintf_s(filename, _TRUNCATE, "%s.bag", fileBase);
-		auto pBag = UniqueGamePtr<CCFileClass>(GameCreate<CCFileClass>(filename));
+	AudioIDXHeader headerIndex;
+	if(!index.Read(0, &headerIndex, sizeof(headerIndex))) {
+		return;
+	}
 
-		if(pBag->Exists() && pBag->Open(FileAccessMode::Read)) {
-			AudioIDXHeader headerIndex;
+	_snprintf_s(filename, _TRUNCATE, "%s.bag", fileBase);
+	auto pBag = UniqueGamePtr<CCFileClass>(GameCreate<CCFileClass>(filename));
 
-			if(pIndex->Read(headerIndex)) {
-				std::vector<AudioIDXEntry> entries;
+	if(pBag->Exists() && pBag->Open(FileAccessMode::Read)) {
+		std::vector<AudioIDXEntry> entries;
 
-				if(headerIndex.numSamples > 0) {
-					entries.resize(headerIndex.numSamples, {});
+		if(headerIndex.numSamples > 0) {
+			entries.resize(headerIndex.numSamples, {});
 
-					auto const Size = sizeof(AudioIDXEntry);
+			auto const Size = sizeof(AudioIDXEntry);
+			auto offset = sizeof(headerIndex);
 
-					if(headerIndex.Magic == 1) {
-						for(auto& entry : entries) {
-							if(!pIndex->Read(entry, Size - 4)) {
-								return;
-							}
-							entry.ChunkSize = 0;
-						}
-					} else {
-						auto const headerSize = headerIndex.numSamples * Size;
-						if(!pIndex->Read(entries[0], static_cast<int>(headerSize))) {
-							return;
-						}
+			if(headerIndex.Magic == 1) {
+				for(auto& entry : entries) {
+					if(!index.Read(offset, &entry, Size - 4)) {
+						return;
 					}
+					entry.ChunkSize = 0;
+					offset += Size - 4;
+				}
+			} else {
+				auto const headerSize = headerIndex.numSamples * Size;
+				if(!index.Read(offset, entries.data(), headerSize)) {
+					return;
 				}
-
-				std::sort(entries.begin(), entries.end());
-				this->Bag = std::move(pBag);
-				this->Entries = std::move(entries);
 			}
 		}
+
+		if(index.IsMapped()) {
+			++MappedIndexes;
+		}
+
+		std::sort(entries.begin(), entries.end());
+		this->Bag = std::move(pBag);
+		this->Entries = std::move(entries);
+	}
+}
+
+unsigned int AudioLuggage::Hash(const char* const pName) {
+	// FNV-1a over the upper case name
+	auto hash = 2166136261u;
+	for(auto i = 0u; i < sizeof(AudioIDXEntry::Name) && pName[i]; ++i) {
+		hash ^= static_cast<unsigned char>(toupper(static_cast<unsigned char>(pName[i])));
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+size_t AudioLuggage::FindSlot(const char* const pName) const {
+	auto const mask = this->Slots.size() - 1;
+	auto slot = Hash(pName) & mask;
+
+	while(true) {
+		auto const idx = this->Slots[slot];
+		if(idx < 0 || !_strnicmp(this->Samples[static_cast<size_t>(idx)].Name,
+			pName, sizeof(AudioIDXEntry::Name)))
+		{
+			return slot;
+		}
+
+		slot = (slot + 1) & mask;
+	}
+}
+
+void AudioLuggage::Rehash(size_t const count) {
+	// keep the table at most half full
+	auto capacity = size_t(16);
+	while(capacity < count * 2) {
+		capacity <<= 1;
+	}
+
+	this->Slots.assign(capacity, -1);
+	for(size_t i = 0; i < this->Samples.size(); ++i) {
+		this->Slots[this->FindSlot(this->Samples[i].Name)] = static_cast<int>(i);
+	}
+}
+
+double AudioLuggage::GetAverageProbes() const {
+	if(this->Samples.empty()) {
+		return 0.0;
+	}
+
+	// how many slots a successful lookup visits
+	auto const mask = this->Slots.size() - 1;
+	size_t probes = 0;
+	for(size_t slot = 0; slot < this->Slots.size(); ++slot) {
+		auto const idx = this->Slots[slot];
+		if(idx >= 0) {
+			auto const home = Hash(this->Samples[static_cast<size_t>(idx)].Name) & mask;
+			probes += ((slot - home) & mask) + 1;
+		}
 	}
+
+	return static_cast<double>(probes) / this->Samples.size();
+}
+
+int AudioLuggage::FindSampleIndex(const char* const pName) const {
+	if(this->Slots.empty() || strlen(pName) > sizeof(AudioIDXEntry::Name)) {
+		return -1;
+	}
+
+	return this->Slots[this->FindSlot(pName)];
+}
+
+void AudioLuggage::LogStatistics(double const milliseconds) const {
+	auto const bags = std::count_if(this->Bags.begin(), this->Bags.end(),
+		[](AudioBag const& bag) { return bag.file() != nullptr; });
+
+	Debug::Log("Audio index: %d bags (%u indexes mapped), %u samples, %u "
+		"replaced by later bags, loaded in %.2f ms. %u hash slots, %.2f "
+		"probes per lookup.\n", bags, MappedIndexes, this->Samples.size(),
+		this->Replaced, milliseconds, this->Slots.size(),
+		this->GetAverageProbes());
 }
 
 AudioIDXData* AudioLuggage::Create(const char* pPath) {
-	std::map<AudioIDXEntry, CCFileClass*> map;
+	size_t total = 0;
+	for(auto const& bag : this->Bags) {
+		total += bag.entries().size();
+	}
+
+	this->Samples.clear();
+	this->Samples.reserve(total);
+	this->Files.clear();
+	this->Files.reserve(total);
+	this->Replaced = 0;
+	this->Rehash(total);
 
+	// samples in later bags replace the ones with the same name in
+	// earlier bags, the entry and the file together
 	for(auto const& bag : this->Bags) {
 		for(auto const& entry : bag.entries()) {
-			map[entry] = bag.file();
+			auto& slot = this->Slots[this->FindSlot(entry.Name)];
+			if(slot < 0) {
+				slot = static_cast<int>(this->Samples.size());
+				this->Samples.push_back(entry);
+				this->Files.push_back(bag.file());
+			} else {
+				auto const idx = static_cast<size_t>(slot);
+				this->Samples[idx] = entry;
+				this->Files[idx] = bag.file();
+				++this->Replaced;
+			}
 		}
 	}
 
-	auto ret = GameCreate<AudioIDXData>();
-	ret->BagFile = nullptr; // this->Bags.front().file(); // not needed
-	ret->SampleCount = static_cast<int>(map.size());
-	ret->Samples = GameCreateArray<AudioIDXEntry>(map.size());
+	// the game expects the samples sorted by name
+	std::vector<size_t> order(this->Samples.size());
+	std::iota(order.begin(), order.end(), size_t(0));
+	std::sort(order.begin(), order.end(), [this](size_t lhs, size_t rhs) {
+		return this->Samples[lhs] < this->Samples[rhs];
+	});
+
+	std::vector<AudioIDXEntry> samples;
+	std::vector<CCFileClass*> files;
+	samples.reserve(order.size());
+	files.reserve(order.size());
+	for(auto const idx : order) {
+		samples.push_back(this->Samples[idx]);
+		files.push_back(this->Files[idx]);
+	}
 
-	this->Files.clear();
-	this->Files.reserve(map.size());
+	this->Samples = std::move(samples);
+	this->Files = std::move(files);
+	this->Rehash(this->Samples.size());
 
-	auto pEntry = ret->Samples;
+	auto ret = GameCreate<AudioIDXData>();
+	ret->BagFile = nullptr; // this->Bags.front().file(); // not needed
+	ret->SampleCount = static_cast<int>(this->Samples.size());
+	ret->Samples = GameCreateArray<AudioIDXEntry>(this->Samples.size());
 
-	for(auto const& item : map) {
-		*pEntry++ = item.first;
-		this->Files.push_back(item.second);
-	}
+	std::copy(this->Samples.begin(), this->Samples.end(), ret->Samples);
 
 #ifdef SUPPORT_PATH
 	if(pPath) {
@@ -160,6 +365,7 @@ AudioIDXData* AudioLuggage::Create(const char* pPath) {
 // this replaces the entire old parser.
 DEFINE_HOOK(4011C0, Audio_Load, 6)
 {
+	Stopwatch timer;
 	auto& luggage = AudioLuggage::Instance;
 
 	// audio.bag and ares.bag
@@ -175,6 +381,7 @@ DEFINE_HOOK(4011C0, Audio_Load, 6)
 
 	// generate index
 	R->EAX(luggage.Create());
+	luggage.LogStatistics(timer.ElapsedMilliseconds());
 	return 0x401578;
 }
 
@@ -193,7 +400,7 @@ DEFINE_HOOK(4064A0, VocClass_AddSample, 0) // Complete rewrite of VocClass::AddS
 			}
 
 			auto idxSample = !AudioIDXData::Instance ? -1
-				: AudioIDXData::Instance->FindSampleIndex(pSampleName);
+				: AudioLuggage::Instance.FindSampleIndex(pSampleName);
 
 			if(idxSample == -1) {
 				idxSample = LooseAudioCache::Instance.GetIndex(pSampleName);
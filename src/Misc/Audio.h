@@ -2,9 +2,9 @@
 
 #include <Audio.h>
 
-#include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 // do not change! this is not a game constant, but a technical one.
@@ -31,16 +31,20 @@ public:
 	}
 
 	int GetIndex(const char* pFilename) {
-		auto it = this->Files.find(pFilename);
+		// look up through a reused key, so known names do not allocate
+		this->LookupKey.assign(pFilename);
+		auto it = this->Files.find(this->LookupKey);
 		if(it == this->Files.end()) {
-			it = this->Files.emplace(pFilename, LooseAudioFile()).first;
+			it = this->Files.emplace(this->LookupKey, LooseAudioFile()).first;
 		}
 
+		// the nodes never move, so the key can serve as the index
 		return reinterpret_cast<int>(it->first.c_str());
 	}
 
 private:
-	std::map<std::string, LooseAudioFile, std::less<>> Files;
+	std::unordered_map<std::string, LooseAudioFile> Files;
+	std::string LookupKey;
 };
 
 class AresAudioHelper {
@@ -117,7 +121,30 @@ public:
 		return this->Files[static_cast<unsigned int>(index)];
 	}
 
+	// the index of the sample in the created AudioIDXData, or -1 if there
+	// is no such sample. the name is not case sensitive.
+	int FindSampleIndex(const char* pName) const;
+
+	void LogStatistics(double milliseconds) const;
+
 private:
+	static unsigned int Hash(const char* pName);
+
+	// finds the slot for this name, either the one holding it or the
+	// empty one it would be inserted into
+	size_t FindSlot(const char* pName) const;
+
+	void Rehash(size_t count);
+
+	double GetAverageProbes() const;
+
 	std::vector<AudioBag> Bags;
 	std::vector<CCFileClass*> Files;
+
+	// open addressing hash table over Samples, storing the sample indexes
+	// or -1 for empty slots. the size is a power of two.
+	std::vector<int> Slots;
+	std::vector<AudioIDXEntry> Samples;
+
+	unsigned int Replaced{ 0 };
 };
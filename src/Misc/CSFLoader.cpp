@@ -1,43 +1,172 @@
 #include "CSFLoader.h"
 #include <algorithm>
+#include <cctype>
 #include <cstdio>
 
 #include "../Ares.h"
+#include "../Utilities/Stopwatch.h"
 
 int CSFLoader::CSFCount = 0;
 int CSFLoader::NextValueIndex = 0;
+int CSFLoader::Capacity = 0;
 std::unordered_map<std::string, const CSFString*> CSFLoader::DynamicStrings;
+std::vector<CSFLoader::IndexSlot> CSFLoader::Index;
+std::vector<CSFLoader::AdditionalCSF> CSFLoader::Files;
+
+int CSFLoader::GetLabelCount(const char* const pFileName, bool const ignoreLanguage) {
+	auto ret = -1;
+
+	CCFileClass* pFile = GameCreate<CCFileClass>(pFileName);
+	if(pFile->Exists() && pFile->Open(FileAccessMode::Read)) {
+		CSFHeader header;
+
+		if(pFile->Read(header)) {
+			if(header.Signature == CSF_SIGNATURE &&
+				header.CSFVersion >= 2 &&
+				(header.Language == StringTable::Language //should stay in one language
+					|| header.Language == static_cast<CSFLanguages>(-1)
+					|| ignoreLanguage))
+			{
+				ret = std::max(header.NumLabels, 0);
+			}
+		}
+	}
+	GameDelete(pFile);
 
-void CSFLoader::LoadAdditionalCSF(const char *pFileName, bool ignoreLanguage)
-{
+	return ret;
+}
+
+int CSFLoader::FindAdditionalCSFs() {
+	Files.clear();
+
+	auto total = 0;
+	auto const Add = [&total](const char* const pFileName, bool const ignoreLanguage) {
+		auto const count = GetLabelCount(pFileName, true);
+		if(count >= 0) {
+			Files.push_back(AdditionalCSF{ pFileName, count, ignoreLanguage });
+			total += count;
+		}
+	};
+
+	Add("ares.csf", true);
+
+	char fname[32];
+	for(int idx = 0; idx < 100; ++idx) {
+		_snprintf_s(fname, _TRUNCATE, "stringtable%02d.csf", idx);
+		Add(fname, false);
+	}
+
+	return total;
+}
+
+void CSFLoader::LoadAdditionalCSFs() {
 	//The main stringtable must have been loaded (memory allocation)
 	//To do that, use StringTable::LoadFile.
-	if(StringTable::IsLoaded && pFileName && *pFileName) {
-		CCFileClass* pFile = GameCreate<CCFileClass>(pFileName);
-		if(pFile->Exists() && pFile->Open(FileAccessMode::Read)) {
-			CSFHeader header;
-
-			if(pFile->Read(header)) {
-				if(header.Signature == CSF_SIGNATURE &&
-					header.CSFVersion >= 2 &&
-					(header.Language == StringTable::Language //should stay in one language
-						|| header.Language == static_cast<CSFLanguages>(-1)
-						|| ignoreLanguage))
-				{
-					++CSFCount;
-					StringTable::ReadFile(pFileName); //must be modified to do the rest ;)
-
-					std::sort(StringTable::Labels, StringTable::Labels + StringTable::LabelCount,
-						[](const CSFLabel& lhs, const CSFLabel& rhs)
-					{
-						return _strcmpi(lhs.Name, rhs.Name) < 0;
-					});
-				}
-			}
+	if(!StringTable::IsLoaded) {
+		return;
+	}
+
+	Stopwatch timer;
+	auto const baseLabels = StringTable::LabelCount;
+
+	IndexLabels();
+
+	for(auto const& file : Files) {
+		auto const pFileName = file.FileName.c_str();
+		if(GetLabelCount(pFileName, file.IgnoreLanguage) < 0) {
+			continue;
+		}
+
+		// only if the memory was allocated for this file
+		auto const used = std::max(StringTable::LabelCount, StringTable::ValueCount);
+		if(used + file.Labels > Capacity) {
+			Debug::Log(Debug::Severity::Error, "[CSFLoader] No room for the %d "
+				"labels of \"%s\", skipping it.\n", file.Labels, pFileName);
+			continue;
+		}
+
+		++CSFCount;
+		StringTable::ReadFile(pFileName); //must be modified to do the rest ;)
+	}
+
+	// the labels are sorted only once, the game finds them with a binary
+	// search. the index has to be rebuilt afterwards.
+	if(CSFCount) {
+		std::sort(StringTable::Labels, StringTable::Labels + StringTable::LabelCount,
+			[](const CSFLabel& lhs, const CSFLabel& rhs)
+		{
+			return _strcmpi(lhs.Name, rhs.Name) < 0;
+		});
+
+		IndexLabels();
+	}
+
+	Debug::Log("[CSFLoader] Loaded %d additional string tables in %.2f ms. "
+		"%d labels, %d from the base table, room for %d.\n", CSFCount,
+		timer.ElapsedMilliseconds(), StringTable::LabelCount, baseLabels,
+		Capacity);
+}
+
+unsigned int CSFLoader::Hash(const char* const pLabelName) {
+	// FNV-1a over the upper case name
+	auto hash = 2166136261u;
+	for(auto i = 0u; i < sizeof(CSFLabel::Name) && pLabelName[i]; ++i) {
+		hash ^= static_cast<unsigned char>(toupper(static_cast<unsigned char>(pLabelName[i])));
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+size_t CSFLoader::FindSlot(const char* const pLabelName, unsigned int const hash) {
+	auto const mask = Index.size() - 1;
+	auto slot = hash & mask;
+
+	while(true) {
+		auto const& item = Index[slot];
+		if(item.Label < 0 || (item.Hash == hash && !_strnicmp(
+			StringTable::Labels[item.Label].Name, pLabelName, sizeof(CSFLabel::Name))))
+		{
+			return slot;
 		}
-		GameDelete(pFile);
+
+		slot = (slot + 1) & mask;
+	}
+}
+
+void CSFLoader::AddToIndex(int const index) {
+	auto const pName = StringTable::Labels[index].Name;
+	auto const hash = Hash(pName);
+
+	auto& item = Index[FindSlot(pName, hash)];
+	item.Hash = hash;
+	item.Label = index;
+}
+
+void CSFLoader::IndexLabels() {
+	// keep the table at most half full, even when all labels are used
+	auto size = size_t(16);
+	while(size < static_cast<size_t>(std::max(Capacity, StringTable::LabelCount)) * 2) {
+		size <<= 1;
 	}
-};
+
+	Index.assign(size, IndexSlot{ 0, -1 });
+	for(auto i = 0; i < StringTable::LabelCount; ++i) {
+		AddToIndex(i);
+	}
+}
+
+void CSFLoader::ClearIndex() {
+	Index.clear();
+}
+
+const CSFLabel* CSFLoader::FindLabel(const char* const pLabelName) {
+	if(Index.empty() || strlen(pLabelName) > sizeof(CSFLabel::Name)) {
+		return nullptr;
+	}
+
+	auto const& item = Index[FindSlot(pLabelName, Hash(pLabelName))];
+	return item.Label < 0 ? nullptr : &StringTable::Labels[item.Label];
+}
 
 const CSFString* CSFLoader::FindDynamic(const char* pLabelName) {
 	if(pLabelName) {
@@ -77,6 +206,10 @@ DEFINE_HOOK(7346D0, CSF_LoadBaseFile, 6)
 {
 	StringTable::IsLoaded = true;
 	CSFLoader::CSFCount = 0;
+	CSFLoader::Capacity = 0;
+
+	// the labels are reallocated, the old index would point into freed memory
+	CSFLoader::ClearIndex();
 
 	return 0;
 }
@@ -86,12 +219,20 @@ DEFINE_HOOK(734823, CSF_AllocateMemory, 6)
 {
 	//aaaah... finally, some serious hax :)
 	//we don't allocate memory by the amount of labels in the base CSF,
-	//but enough for exactly MaxEntries entries.
+	//but enough for the base CSF and all additional ones.
 	//We're assuming we have only one value for one label, which is standard.
 
-	StringTable::Labels = GameCreateArray<CSFLabel>(CSFLoader::MaxEntries);
-	StringTable::Values = GameCreateArray<wchar_t*>(CSFLoader::MaxEntries);
-	StringTable::ExtraValues = GameCreateArray<char*>(CSFLoader::MaxEntries);
+	auto base = std::max(StringTable::LabelCount, StringTable::ValueCount);
+	if(base <= 0) {
+		base = CSFLoader::DefaultBaseEntries;
+	}
+
+	auto const capacity = base + CSFLoader::FindAdditionalCSFs();
+	CSFLoader::Capacity = capacity;
+
+	StringTable::Labels = GameCreateArray<CSFLabel>(static_cast<size_t>(capacity));
+	StringTable::Values = GameCreateArray<wchar_t*>(static_cast<size_t>(capacity));
+	StringTable::ExtraValues = GameCreateArray<char*>(static_cast<size_t>(capacity));
 
 	return 0x7348BC;
 }
@@ -101,12 +242,8 @@ DEFINE_HOOK(734A5F, CSF_AddOrOverrideLabel, 5)
 {
 	if(CSFLoader::CSFCount > 0)
 	{
-		CSFLabel* pLabel = static_cast<CSFLabel*>(bsearch(
-			reinterpret_cast<const char*>(0xB1BF38), //label buffer, char[4096]
-			StringTable::Labels,
-			static_cast<size_t>(StringTable::LabelCount),
-			sizeof(CSFLabel),
-			(int (__cdecl *)(const void *,const void *))_strcmpi));
+		auto const pLabelName = reinterpret_cast<const char*>(0xB1BF38); //label buffer, char[4096]
+		auto const pLabel = CSFLoader::FindLabel(pLabelName);
 
 		if(pLabel)
 		{
@@ -144,6 +281,11 @@ DEFINE_HOOK(734A5F, CSF_AddOrOverrideLabel, 5)
 			StringTable::ValueCount = idx + 1;
 			StringTable::LabelCount = StringTable::LabelCount + 1;
 
+			//the game copies the name right after this, but the index
+			//needs it now, so later labels of the same name are found
+			strncpy_s(StringTable::Labels[idx].Name, pLabelName, _TRUNCATE);
+			CSFLoader::AddToIndex(idx);
+
 			R->EBP(idx * sizeof(CSFLabel)); //set the index
 		}
 	}
@@ -166,12 +308,7 @@ DEFINE_HOOK(734A97, CSF_SetIndex, 6)
 
 DEFINE_HOOK(6BD886, CSF_LoadExtraFiles, 5)
 {
-	CSFLoader::LoadAdditionalCSF("ares.csf", true);
-	char fname[32];
-	for(int idx = 0; idx < 100; ++idx) {
-		_snprintf_s(fname, _TRUNCATE, "stringtable%02d.csf", idx);
-		CSFLoader::LoadAdditionalCSF(fname);
-	}
+	CSFLoader::LoadAdditionalCSFs();
 	R->AL(1);
 	return 0x6BD88B;
 }
@@ -187,6 +324,17 @@ DEFINE_HOOK(734E83, CSF_LoadString_1, 6)
 
 		return 0x734F0F;
 	}
+
+	// find it in the index instead of the binary search
+	if(auto const pLabel = CSFLoader::FindLabel(Name)) {
+		if(pLabel->NumValues > 0) {
+			if(auto const pValue = StringTable::Values[pLabel->FirstValueIndex]) {
+				R->EAX(pValue);
+				return 0x734F0F;
+			}
+		}
+	}
+
 	return 0;
 }
 
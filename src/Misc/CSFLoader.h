@@ -9,20 +9,62 @@
 #include <CCFileClass.h>
 #include <StringTable.h>
 
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 class CSFLoader
 {
 public:
-	static auto const MaxEntries = 20000u;
+	// room for the base string table if the game did not tell its size
+	static auto const DefaultBaseEntries = 20000;
 
 	static int CSFCount;
 	static int NextValueIndex;
 
-	static void LoadAdditionalCSF(const char* fileName, bool ignoreLanguage = false);
+	// how many labels and values the string table has room for
+	static int Capacity;
+
+	// finds the additional CSF files and returns how many labels they have.
+	// the language is checked when they are loaded.
+	static int FindAdditionalCSFs();
+
+	// reads all files found, then sorts the labels once
+	static void LoadAdditionalCSFs();
+
+	// forgets all labels, until the string table is indexed again
+	static void ClearIndex();
+
+	// the label with this name, or nullptr. not case sensitive.
+	static const CSFLabel* FindLabel(const char* pLabelName);
 
 	static std::unordered_map<std::string, const CSFString*> DynamicStrings;
 
 	static const CSFString* FindDynamic(const char* name);
 	static const wchar_t* GetDynamicString(const char* name, const wchar_t* pattern, const char* def);
+
+private:
+	// returns the number of labels, or -1 if the file cannot be used
+	static int GetLabelCount(const char* pFileName, bool ignoreLanguage);
+
+	static unsigned int Hash(const char* pLabelName);
+	static size_t FindSlot(const char* pLabelName, unsigned int hash);
+	static void AddToIndex(int index);
+	static void IndexLabels();
+
+	struct IndexSlot {
+		unsigned int Hash;
+		int Label; // index into StringTable::Labels, or -1 if empty
+	};
+
+	// open addressing hash table over the labels, the size is a power of two
+	static std::vector<IndexSlot> Index;
+
+	struct AdditionalCSF {
+		std::string FileName;
+		int Labels;
+		bool IgnoreLanguage;
+	};
+
+	static std::vector<AdditionalCSF> Files;
 };
@@ -12,7 +12,12 @@
 #include <ScenarioClass.h>
 #include <FPSCounter.h>
 #include <GameOptionsClass.h>
+#include "../Ares.h"
 #include "../Ares.version.h"
+#include "SyncLogFormat.h"
+
+#include <bitset>
+#include <vector>
 
 #ifdef MAKE_GAME_SLOWER_FOR_NO_REASON
 template<typename T>
@@ -181,19 +186,29 @@ void WriteLogLine(const T* it, int idx, DWORD checksum, FILE * F) {
 }
 
 template<typename T>
-void LogItem(const T* it, int idx, FILE * F) {
-	if(it->WhatAmI() != AnimClass::AbsID || it->Fetch_ID() != -2) {
-		DWORD Checksum(0);
+bool IsLogged(const T* it) {
+	return it->WhatAmI() != AnimClass::AbsID || it->Fetch_ID() != -2;
+}
+
+template<typename T>
+DWORD GetChecksum(const T* it) {
+	DWORD Checksum(0);
 #ifdef MAKE_GAME_SLOWER_FOR_NO_REASON
-		if(auto ExtData = AbstractExt::ExtMap.Find(it)) {
-			Checksum = ExtData->LastChecksum;
-		}
+	if(auto ExtData = AbstractExt::ExtMap.Find(it)) {
+		Checksum = ExtData->LastChecksum;
+	}
 #else
-		SafeChecksummer Ch;
-		it->CalculateChecksum(Ch);
-		Checksum = Ch.Intermediate();
+	SafeChecksummer Ch;
+	it->CalculateChecksum(Ch);
+	Checksum = Ch.Intermediate();
 #endif
-		WriteLogLine(it, idx, Checksum, F);
+	return Checksum;
+}
+
+template<typename T>
+void LogItem(const T* it, int idx, FILE * F) {
+	if(IsLogged(it)) {
+		WriteLogLine(it, idx, GetChecksum(it), F);
 	}
 }
 
@@ -300,14 +315,180 @@ bool LogFrame(const char * LogFilename, NetworkEvent *OffendingEvent = nullptr)
 	}
 }
 
+// the same information as LogFrame, but as fixed size records that can be
+// compared with the syncdiff tool. see SyncLogFormat.h for the layout.
+class BinarySyncLog {
+public:
+	explicit BinarySyncLog(NetworkEvent* OffendingEvent) : Header() {
+		memcpy(this->Header.Magic, SyncLog::Magic, sizeof(SyncLog::Magic));
+		this->Header.Version = SyncLog::Version;
+		strncpy_s(this->Header.AresVersion, VERSION_STR, _TRUNCATE);
+
+		this->Header.Frame = Unsorted::CurrentFrame;
+		this->Header.Random = ScenarioClass::Instance->Random.Random();
+		this->Header.PlayerIndex = HouseClass::Player->ArrayIndex;
+
+		if(OffendingEvent) {
+			this->Header.HasEvent = 1;
+			this->Header.EventKind = static_cast<int32_t>(OffendingEvent->Kind);
+			this->Header.EventFrame = static_cast<int32_t>(OffendingEvent->Timestamp);
+			this->Header.EventHouse = static_cast<int32_t>(OffendingEvent->HouseIndex);
+			this->Header.EventChecksum = OffendingEvent->Checksum;
+		}
+	}
+
+	void AddFrames() {
+		// the game keeps the checksums of the last 0x100 frames, indexed by
+		// the frame number
+		for(auto ixF = 0; ixF < 0x100; ++ixF) {
+			auto const frame = Unsorted::CurrentFrame - 0xFF + ixF;
+			if(frame >= 0) {
+				SyncLog::FrameRecord record;
+				record.Frame = frame;
+				record.CRC = Networking::LatestFramesCRC[frame & 0xFF];
+				this->Frames.push_back(record);
+			}
+		}
+	}
+
+	void AddTypes() {
+		if(auto const pArray = AbstractTypeClass::Array) {
+			for(auto const& pType : *pArray) {
+				SyncLog::TypeRecord record = {};
+				record.What = this->AddClass(pType->WhatAmI());
+				record.Index = pType->GetArrayIndex();
+				record.Checksum = GetChecksum(pType);
+				strncpy_s(record.ID, pType->ID, _TRUNCATE);
+				this->Types.push_back(record);
+			}
+		}
+	}
+
+	void AddHouses() {
+		auto const& Houses = *HouseClass::Array;
+		for(auto i = 0; i < Houses.Count; ++i) {
+			auto const pHouse = Houses.GetItem(i);
+
+			SyncLog::ObjectRecord record = {};
+			record.List = static_cast<uint8_t>(SyncLog::List::Houses);
+			record.What = this->AddClass(pHouse->WhatAmI());
+			record.Index = i;
+			record.UniqueID = pHouse->UniqueID;
+			record.Checksum = GetChecksum(pHouse);
+			record.TypeWhat = this->AddClass(pHouse->Type->WhatAmI());
+			record.TypeIndex = pHouse->Type->ArrayIndex;
+			record.Value = pHouse->Available_Money();
+			this->Objects.push_back(record);
+		}
+	}
+
+	void AddAbstracts() {
+		if(auto const pArray = AbstractClass::Array0) {
+			for(auto i = 0; i < pArray->Count; ++i) {
+				auto const it = pArray->Items[i];
+				if(!IsLogged(it)) {
+					continue;
+				}
+
+				SyncLog::ObjectRecord record = {};
+				record.List = static_cast<uint8_t>(SyncLog::List::Abstracts);
+				record.What = this->AddClass(it->WhatAmI());
+				record.Index = i;
+				record.UniqueID = it->UniqueID;
+				record.Checksum = GetChecksum(it);
+				record.TypeIndex = -1;
+
+				if(auto const pObject = abstract_cast<ObjectClass*>(it)) {
+					if(auto const pType = pObject->GetType()) {
+						record.TypeWhat = this->AddClass(pType->WhatAmI());
+						record.TypeIndex = pType->GetArrayIndex();
+					}
+
+					auto const crd = pObject->GetCoords();
+					record.X = crd.X;
+					record.Y = crd.Y;
+					record.Z = crd.Z;
+					record.Value = pObject->Health;
+					record.InLimbo = pObject->InLimbo;
+				}
+
+				this->Objects.push_back(record);
+			}
+		}
+	}
+
+	bool Write(const char* LogFilename) {
+		FILE* LogFile = nullptr;
+		if(fopen_s(&LogFile, LogFilename, "wb") || !LogFile) {
+			Debug::Log("Failed to open file for binary sync log. Error code %X.\n", errno);
+			return false;
+		}
+
+		this->Header.ClassCount = this->Classes.size();
+		this->Header.FrameCount = this->Frames.size();
+		this->Header.TypeCount = this->Types.size();
+		this->Header.ObjectCount = this->Objects.size();
+
+		fwrite(&this->Header, sizeof(this->Header), 1, LogFile);
+		WriteRecords(this->Classes, LogFile);
+		WriteRecords(this->Frames, LogFile);
+		WriteRecords(this->Types, LogFile);
+		WriteRecords(this->Objects, LogFile);
+
+		fclose(LogFile);
+		return true;
+	}
+
+private:
+	uint8_t AddClass(AbstractType const abs) {
+		auto const what = static_cast<uint8_t>(abs);
+		if(!this->SeenClasses[what]) {
+			this->SeenClasses[what] = true;
+
+			SyncLog::ClassRecord record = {};
+			record.What = what;
+			strncpy_s(record.Name, AbstractClass::GetClassName(abs), _TRUNCATE);
+			this->Classes.push_back(record);
+		}
+		return what;
+	}
+
+	template<typename T>
+	static void WriteRecords(const std::vector<T>& Records, FILE* F) {
+		if(!Records.empty()) {
+			fwrite(Records.data(), sizeof(T), Records.size(), F);
+		}
+	}
+
+	SyncLog::Header Header;
+	std::bitset<0x100> SeenClasses;
+	std::vector<SyncLog::ClassRecord> Classes;
+	std::vector<SyncLog::FrameRecord> Frames;
+	std::vector<SyncLog::TypeRecord> Types;
+	std::vector<SyncLog::ObjectRecord> Objects;
+};
+
+bool LogFrameBinary(const char * LogFilename, NetworkEvent *OffendingEvent = nullptr) {
+	BinarySyncLog Log(OffendingEvent);
+	Log.AddFrames();
+	Log.AddTypes();
+	Log.AddHouses();
+	Log.AddAbstracts();
+	return Log.Write(LogFilename);
+}
+
 DEFINE_HOOK(64DEA0, Multiplay_LogToSYNC_NOMPDEBUG, 0)
 {
 	GET(NetworkEvent *, OffendingEvent, ECX);
 	
 	char LogFilename[0x40];
-	_snprintf_s(LogFilename, _TRUNCATE, "SYNC%01d.TXT", HouseClass::Player->ArrayIndex);
-
-	LogFrame(LogFilename, OffendingEvent);
+	if(Ares::bBinarySyncLog) {
+		_snprintf_s(LogFilename, _TRUNCATE, "SYNC%01d.BIN", HouseClass::Player->ArrayIndex);
+		LogFrameBinary(LogFilename, OffendingEvent);
+	} else {
+		_snprintf_s(LogFilename, _TRUNCATE, "SYNC%01d.TXT", HouseClass::Player->ArrayIndex);
+		LogFrame(LogFilename, OffendingEvent);
+	}
 
 	return 0x64DF3D;
 }
@@ -318,9 +499,13 @@ DEFINE_HOOK(6516F0, Multiplay_LogToSync_MPDEBUG, 6)
 	GET(NetworkEvent *, OffendingEvent, EDX);
 	
 	char LogFilename[0x40];
-	_snprintf_s(LogFilename, _TRUNCATE, "SYNC%01d_%03d.TXT", HouseClass::Player->ArrayIndex, SlotNumber);
-
-	LogFrame(LogFilename, OffendingEvent);
+	if(Ares::bBinarySyncLog) {
+		_snprintf_s(LogFilename, _TRUNCATE, "SYNC%01d_%03d.BIN", HouseClass::Player->ArrayIndex, SlotNumber);
+		LogFrameBinary(LogFilename, OffendingEvent);
+	} else {
+		_snprintf_s(LogFilename, _TRUNCATE, "SYNC%01d_%03d.TXT", HouseClass::Player->ArrayIndex, SlotNumber);
+		LogFrame(LogFilename, OffendingEvent);
+	}
 
 	return 0x651781;
 }
@@ -9,7 +9,208 @@
 
 #include <Dbghelp.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdarg>
+#include <vector>
+
+namespace {
+	// collects log output in a ring buffer that a background thread writes
+	// to the log file in large chunks, so the game does not wait for the
+	// disk on every line. the game only waits if it flushes explicitly.
+	//
+	// producers serialize on a tiny spin lock, so this is not lock-free.
+	// the lock is only held for a copy into the buffer, and waiting
+	// producers give up their time slice after a short spin, so a producer
+	// preempted while holding it does not stall the others for long. the
+	// writer thread never blocks them. if the buffer is full, whole lines
+	// are dropped and counted, and a note is written to the log in their
+	// place.
+	class LogWriter {
+	public:
+		bool IsRunning() const {
+			return this->Thread != nullptr;
+		}
+
+		bool Start(FILE* pFile, size_t size);
+		void Stop();
+
+		void Write(const char* pData, size_t length);
+		void Drain();
+
+		unsigned int GetDroppedLines() const {
+			return this->DroppedTotal;
+		}
+
+	private:
+		static DWORD WINAPI ThreadProc(LPVOID pParameter);
+
+		FILE* File{ nullptr };
+		std::vector<char> Buffer;
+		size_t Mask{ 0 };
+
+		std::atomic<size_t> Head{ 0 }; // advanced by the producers
+		std::atomic<size_t> Tail{ 0 }; // advanced by Drain
+		std::atomic<bool> Locked{ false };
+		bool DroppingLine{ false };
+
+		std::atomic<unsigned int> DroppedPending{ 0 };
+		unsigned int DroppedTotal{ 0 };
+
+		std::atomic<bool> Stopping{ false };
+		CRITICAL_SECTION DrainLock;
+		HANDLE WakeEvent{ nullptr };
+		HANDLE Thread{ nullptr };
+	};
+
+	LogWriter Writer;
+
+	bool LogWriter::Start(FILE* const pFile, size_t const size) {
+		// the indices wrap around using a mask
+		auto capacity = size_t(0x1000);
+		while(capacity < size) {
+			capacity <<= 1;
+		}
+
+		this->File = pFile;
+		this->Buffer.assign(capacity, '\0');
+		this->Mask = capacity - 1;
+		this->Head = 0;
+		this->Tail = 0;
+		this->DroppingLine = false;
+		this->DroppedPending = 0;
+		this->DroppedTotal = 0;
+		this->Stopping = false;
+
+		InitializeCriticalSection(&this->DrainLock);
+		this->WakeEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+		if(this->WakeEvent) {
+			this->Thread = CreateThread(
+				nullptr, 0, &LogWriter::ThreadProc, this, 0, nullptr);
+		}
+
+		if(!this->Thread) {
+			if(this->WakeEvent) {
+				CloseHandle(this->WakeEvent);
+				this->WakeEvent = nullptr;
+			}
+			DeleteCriticalSection(&this->DrainLock);
+			this->Buffer.clear();
+			return false;
+		}
+
+		return true;
+	}
+
+	void LogWriter::Stop() {
+		if(!this->Thread) {
+			return;
+		}
+
+		this->Stopping = true;
+		SetEvent(this->WakeEvent);
+		WaitForSingleObject(this->Thread, INFINITE);
+		CloseHandle(this->Thread);
+		this->Thread = nullptr;
+
+		// anything logged while the thread was shutting down
+		this->Drain();
+
+		CloseHandle(this->WakeEvent);
+		this->WakeEvent = nullptr;
+		DeleteCriticalSection(&this->DrainLock);
+
+		std::vector<char>().swap(this->Buffer);
+		this->File = nullptr;
+	}
+
+	void LogWriter::Write(const char* const pData, size_t const length) {
+		auto const capacity = this->Buffer.size();
+		auto const endsLine = length && pData[length - 1] == '\n';
+
+		for(auto spins = 0; this->Locked.exchange(true, std::memory_order_acquire); ++spins) {
+			// wait for the lock to look free before trying again
+			while(this->Locked.load(std::memory_order_relaxed)) {
+				if(spins < 64) {
+					YieldProcessor();
+				} else {
+					SwitchToThread();
+				}
+				++spins;
+			}
+		}
+
+		auto const head = this->Head.load(std::memory_order_relaxed);
+		auto const used = head - this->Tail.load(std::memory_order_acquire);
+
+		// once part of a line was dropped, drop the rest of it, too
+		if(this->DroppingLine || length > capacity - used) {
+			auto const lines = static_cast<unsigned int>(
+				std::count(pData, pData + length, '\n'));
+			this->DroppedPending.fetch_add(lines, std::memory_order_relaxed);
+			this->DroppingLine = !endsLine;
+		} else {
+			auto const offset = head & this->Mask;
+			auto const first = std::min(length, capacity - offset);
+			memcpy(&this->Buffer[offset], pData, first);
+			memcpy(&this->Buffer[0], pData + first, length - first);
+
+			this->Head.store(head + length, std::memory_order_release);
+
+			// wake the writer early if the buffer is filling up
+			auto const quarter = capacity / 4;
+			if(used < quarter && used + length >= quarter) {
+				SetEvent(this->WakeEvent);
+			}
+		}
+
+		this->Locked.store(false, std::memory_order_release);
+	}
+
+	void LogWriter::Drain() {
+		EnterCriticalSection(&this->DrainLock);
+
+		auto const capacity = this->Buffer.size();
+		auto tail = this->Tail.load(std::memory_order_relaxed);
+		auto const head = this->Head.load(std::memory_order_acquire);
+		auto const written = tail != head;
+
+		while(tail != head) {
+			auto const offset = tail & this->Mask;
+			auto const chunk = std::min(head - tail, capacity - offset);
+			fwrite(&this->Buffer[offset], 1, chunk, this->File);
+			tail += chunk;
+		}
+
+		this->Tail.store(tail, std::memory_order_release);
+
+		if(auto const dropped = this->DroppedPending.exchange(0)) {
+			this->DroppedTotal += dropped;
+			fprintf(this->File, "[Developer warning] The log buffer overflowed, "
+				"%u lines were dropped around here.\n", dropped);
+		}
+
+		if(written) {
+			fflush(this->File);
+		}
+
+		LeaveCriticalSection(&this->DrainLock);
+	}
+
+	DWORD WINAPI LogWriter::ThreadProc(LPVOID const pParameter) {
+		auto const pThis = static_cast<LogWriter*>(pParameter);
+
+		while(!pThis->Stopping) {
+			WaitForSingleObject(pThis->WakeEvent, 50);
+			pThis->Drain();
+		}
+
+		return 0;
+	}
+}
+
 bool Debug::bLog = true;
+size_t Debug::LogBufferSize = 0x100000;
 bool Debug::bTrackParserErrors = false;
 bool Debug::bParserErrorDetected = false;
 
@@ -46,6 +247,10 @@ void Debug::LogFlushed(
 		va_start(args, pFormat);
 		Debug::LogWithVArgs(pFormat, args);
 		va_end(args);
+
+		if(severity == Severity::Fatal) {
+			Debug::FlushLog();
+		}
 	}
 }
 
@@ -74,11 +279,48 @@ void __cdecl Debug::LogUnflushed(const char* const pFormat, ...) {
 void Debug::LogWithVArgsUnflushed(
 	const char* const pFormat, va_list const args)
 {
-	vfprintf(Debug::LogFile, pFormat, args);
+	if(!Writer.IsRunning()) {
+		vfprintf(Debug::LogFile, pFormat, args);
+		return;
+	}
+
+	// format on the stack, only very long lines need more
+	char buffer[0x800];
+
+	va_list copy;
+	va_copy(copy, args);
+	auto const length = vsnprintf(buffer, sizeof(buffer), pFormat, copy);
+	va_end(copy);
+
+	if(length < 0) {
+		return;
+	}
+
+	auto const size = static_cast<size_t>(length);
+	if(size < sizeof(buffer)) {
+		Writer.Write(buffer, size);
+	} else {
+		std::vector<char> large(size + 1);
+		vsnprintf(large.data(), large.size(), pFormat, args);
+		Writer.Write(large.data(), size);
+	}
 }
 
 void Debug::Flush() {
-	fflush(Debug::LogFile);
+	// the writer thread flushes on its own
+	if(!Writer.IsRunning()) {
+		fflush(Debug::LogFile);
+	}
+}
+
+void Debug::FlushLog() {
+	if(Debug::LogFile) {
+		if(Writer.IsRunning()) {
+			Writer.Drain();
+		} else {
+			fflush(Debug::LogFile);
+		}
+	}
 }
 
 void Debug::LogFileOpen()
@@ -93,11 +335,23 @@ void Debug::LogFileOpen()
 		MessageBoxW(Game::hWnd, Debug::LogFileTempName.c_str(), msg, MB_OK | MB_ICONEXCLAMATION);
 		ExitProcess(1);
 	}
+
+	if(Debug::LogBufferSize && !Writer.Start(LogFile, Debug::LogBufferSize)) {
+		fprintf(LogFile, "Could not start the log writer thread, "
+			"writing the log unbuffered.\n");
+	}
 }
 
 void Debug::LogFileClose(int tag)
 {
 	if(Debug::LogFile) {
+		Writer.Stop();
+
+		if(auto const dropped = Writer.GetDroppedLines()) {
+			fprintf(Debug::LogFile, "The log buffer overflowed, %u lines were "
+				"dropped. Use -LOGBUFFER= to make it larger.\n", dropped);
+		}
+
 		fprintf(Debug::LogFile, "Closing log file on request %d", tag);
 		fclose(Debug::LogFile);
 		CopyFileW(Debug::LogFileTempName.c_str(), Debug::LogFileName.c_str(), FALSE);
@@ -242,6 +496,7 @@ void Debug::FatalError(bool Dump) {
 
 	Debug::Log("\nFatal Error:\n");
 	Debug::Log("%s\n", Ares::readBuffer);
+	Debug::FlushLog();
 
 	MessageBoxW(Game::hWnd, Message, L"Fatal Error - Yuri's Revenge", MB_OK | MB_ICONERROR);
 
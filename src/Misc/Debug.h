@@ -45,6 +45,9 @@ public:
 
 	static void LogWithVArgs(const char* const pFormat, va_list args);
 
+	// writes everything logged so far to disk before returning
+	static void FlushLog();
+
 	// parser errors
 
 	static bool bTrackParserErrors;
@@ -75,6 +78,7 @@ public:
 	// unsorted
 
 	static bool bLog;
+	static size_t LogBufferSize; // in bytes, zero writes every line immediately
 	static std::wstring LogFileName;
 	static std::wstring LogFileTempName;
 
@@ -57,6 +57,7 @@ LONG CALLBACK Exception::ExceptionFilter(PEXCEPTION_POINTERS const pExs)
 		std::wstring path = Exception::PrepareSnapshotDirectory();
 
 		if(Debug::bLog) {
+			Debug::FlushLog();
 			std::wstring logCopy = path + L"\\debug.log";
 			CopyFileW(Debug::LogFileTempName.c_str(), logCopy.c_str(), FALSE);
 		}
@@ -95,6 +96,7 @@ LONG CALLBACK Exception::ExceptionFilter(PEXCEPTION_POINTERS const pExs)
 			SetClassLong(Game::hWnd, GCL_HCURSOR, reinterpret_cast<LONG>(loadCursor));
 			SetCursor(loadCursor);
 			Debug::Log("Making a memory dump\n");
+			Debug::FlushLog();
 
 			MINIDUMP_EXCEPTION_INFORMATION expParam;
 			expParam.ThreadId = GetCurrentThreadId();
@@ -177,6 +179,7 @@ std::wstring Exception::FullDump(
 
 [[noreturn]] void Exception::Exit(UINT ExitCode) {
 	Debug::Log("Exiting...\n");
+	Debug::FlushLog();
 	Ares::bShuttingDown = true;
 	ExitProcess(ExitCode);
 }
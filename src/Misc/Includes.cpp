@@ -1,15 +1,216 @@
 #include "../Ares.h"
 #include "Includes.h"
+#include "Debug.h"
+#include "IniSectionIncludes.h"
+#include "../Utilities/Constructs.h"
+
+#include <GenericList.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 int Includes::LastReadIndex = -1;
 DynamicVectorClass<CCINIClass*> Includes::LoadedINIs;
 DynamicVectorClass<char*> Includes::LoadedINIFiles;
 
+namespace {
+	// an included file as it was parsed, identified by size and a hash of its
+	// contents. the file is found the way the game finds it, so this works
+	// for loose files in any search path and for files from mixes alike.
+	struct CachedInclude {
+		// offsets of the null terminated strings of a single entry
+		struct Entry {
+			size_t Section;
+			size_t Key;
+			size_t Value;
+		};
+
+		unsigned long long Size{ 0 };
+		unsigned long long Hash{ 0 };
+		bool Parsed{ false };
+		bool Cacheable{ true };
+
+		// all section names, keys and values in one buffer, so a cached file
+		// needs two allocations instead of several per entry
+		std::vector<char> Strings;
+		std::vector<Entry> Entries;
+
+		const char* GetString(size_t const offset) const {
+			return &this->Strings[offset];
+		}
+
+		size_t GetMemory() const {
+			return this->Strings.capacity()
+				+ this->Entries.capacity() * sizeof(Entry);
+		}
+
+		size_t AddString(const char* const pString) {
+			auto const ret = this->Strings.size();
+			this->Strings.insert(this->Strings.end(), pString, pString + strlen(pString) + 1);
+			return ret;
+		}
+	};
+
+	// upper case file name to parsed file
+	std::unordered_map<std::string, CachedInclude> Cache;
+
+	// the cache lives as long as the process, so its size is limited. files
+	// that do not fit any more are parsed every time.
+	size_t const MaxCacheMemory = 32u << 20;
+	size_t CacheMemory = 0;
+
+	// the empty INI an include is parsed into to fill the cache
+	CCINIClass* ParsingINI = nullptr;
+	bool ParsingCacheable = true;
+
+	unsigned int Hits = 0;
+	unsigned int Misses = 0;
+	unsigned int Uncached = 0;
+
+	// reads the whole file and hashes it (64 bit FNV-1a)
+	bool GetStamp(
+		CCFileClass* const pFile, unsigned long long& size,
+		unsigned long long& hash)
+	{
+		size = 0;
+		hash = 14695981039346656037ull;
+
+		if(!pFile->Open(FileAccessMode::Read)) {
+			return false;
+		}
+
+		auto const length = pFile->GetFileSize();
+		std::vector<unsigned char> buffer(static_cast<size_t>(std::max(length, 0)));
+		auto const read = buffer.empty() ? 0 : pFile->ReadBytes(buffer.data(), length);
+		pFile->Close();
+
+		if(read != length) {
+			return false;
+		}
+
+		size = buffer.size();
+		for(auto const& byte : buffer) {
+			hash = (hash ^ byte) * 1099511628211ull;
+		}
+		return true;
+	}
+
+	void CollectSections(CCINIClass* const pINI, CachedInclude& cached) {
+		for(GenericNode* sectionNode = &pINI->Sections.First; sectionNode; sectionNode = sectionNode->Next) {
+			if(*reinterpret_cast<unsigned int*>(sectionNode) != 0x7EB73C) { // INISection vtable
+				continue;
+			}
+
+			auto const pSection = static_cast<INIClass::INISection*>(sectionNode);
+			auto const name = cached.AddString(pSection->Name);
+
+			for(GenericNode* entryNode = &pSection->Entries.First; entryNode; entryNode = entryNode->Next) {
+				if(*reinterpret_cast<unsigned int*>(entryNode) == 0x7EB734) { // INIEntry vtable
+					auto const pEntry = static_cast<INIClass::INIEntry*>(entryNode);
+					auto const key = cached.AddString(pEntry->Key);
+					auto const value = cached.AddString(pEntry->Value);
+					cached.Entries.push_back({name, key, value});
+				}
+			}
+		}
+
+		cached.Strings.shrink_to_fit();
+		cached.Entries.shrink_to_fit();
+	}
+
+	void MergeSections(CCINIClass* const pINI, CachedInclude const& cached) {
+		for(auto const& entry : cached.Entries) {
+			pINI->WriteString(cached.GetString(entry.Section),
+				cached.GetString(entry.Key), cached.GetString(entry.Value));
+		}
+	}
+}
+
+void Includes::LoadInclude(CCINIClass* const pINI, const char* const pFilename) {
+	auto const pFile = UniqueGamePtr<CCFileClass>(GameCreate<CCFileClass>(pFilename));
+	if(!pFile->Exists()) {
+		return;
+	}
+
+	std::string key(pFilename);
+	_strupr_s(&key[0], key.size() + 1);
+
+	unsigned long long size = 0;
+	unsigned long long hash = 0;
+	auto const stamped = GetStamp(pFile.get(), size, hash);
+
+	auto& cached = Cache[key];
+	auto const current = stamped && cached.Parsed
+		&& cached.Size == size && cached.Hash == hash;
+
+	if(current && !cached.Cacheable) {
+		// parse it into the INI itself, the way the game does
+		++Uncached;
+		pINI->ReadCCFile(pFile.get());
+		return;
+	}
+
+	// the hooks skip the file while it is parsed into the cache
+	Includes::LoadedINIFiles.AddItem(_strdup(pFilename));
+
+	if(current) {
+		++Hits;
+		MergeSections(pINI, cached);
+		return;
+	}
+
+	++Misses;
+	CacheMemory -= cached.GetMemory();
+	cached.Size = size;
+	cached.Hash = hash;
+	cached.Strings.clear();
+	cached.Entries.clear();
+
+	auto const pTemp = UniqueGamePtr<CCINIClass>(GameCreate<CCINIClass>());
+	ParsingINI = pTemp.get();
+	ParsingCacheable = true;
+	pTemp->ReadCCFile(pFile.get());
+	ParsingINI = nullptr;
+
+	cached.Parsed = stamped;
+	cached.Cacheable = ParsingCacheable;
+	if(cached.Cacheable) {
+		CollectSections(pTemp.get(), cached);
+		MergeSections(pINI, cached);
+
+		CacheMemory += cached.GetMemory();
+		if(CacheMemory > MaxCacheMemory) {
+			Debug::Log("Includes: %s does not fit into the cache.\n", pFilename);
+			CacheMemory -= cached.GetMemory();
+			std::vector<char>().swap(cached.Strings);
+			std::vector<CachedInclude::Entry>().swap(cached.Entries);
+			cached.Parsed = false;
+		}
+	} else {
+		Debug::Log("Includes: %s inherits sections and is not cached.\n", pFilename);
+		pINI->ReadCCFile(pFile.get());
+	}
+}
+
+void Includes::DependsOnContents(CCINIClass* const pINI) {
+	if(pINI && pINI == ParsingINI) {
+		ParsingCacheable = false;
+	}
+}
+
 DEFINE_HOOK(474200, CCINIClass_ReadCCFile1, 6)
 {
 	GET(CCINIClass *, pINI, ECX);
 	GET(CCFileClass *, pFile, EAX);
 
+	if(pINI == ParsingINI) {
+		return 0;
+	}
+
 	const char * filename = pFile->GetFileName();
 
 	Includes::LoadedINIs.AddItem(pINI);
@@ -19,6 +220,12 @@ DEFINE_HOOK(474200, CCINIClass_ReadCCFile1, 6)
 
 DEFINE_HOOK(474314, CCINIClass_ReadCCFile2, 6)
 {
+	// nested includes are added to the including INI's section and read
+	// from there
+	if(ParsingINI) {
+		return 0;
+	}
+
 	char buffer[0x80];
 	CCINIClass *xINI = Includes::LoadedINIs[Includes::LoadedINIs.Count - 1];
 
@@ -28,8 +235,8 @@ DEFINE_HOOK(474314, CCINIClass_ReadCCFile2, 6)
 
 	const char* section = "#include";
 
-	int len = xINI->GetKeyCount(section);
-	for(int i = Includes::LastReadIndex; i < len; i = Includes::LastReadIndex) {
+	// cached files add their own includes to the section while it is read
+	for(int i = Includes::LastReadIndex; i < xINI->GetKeyCount(section); i = Includes::LastReadIndex) {
 		const char *key = xINI->GetKeyName(section, i);
 		++Includes::LastReadIndex;
 		buffer[0] = '\0';
@@ -43,11 +250,7 @@ DEFINE_HOOK(474314, CCINIClass_ReadCCFile2, 6)
 			}
 
 			if(canLoad) {
-				CCFileClass *xFile = GameCreate<CCFileClass>(buffer);
-				if(xFile->Exists()) {
-					xINI->ReadCCFile(xFile);
-				}
-				GameDelete(xFile);
+				Includes::LoadInclude(xINI, buffer);
 			}
 		}
 	}
@@ -61,6 +264,18 @@ DEFINE_HOOK(474314, CCINIClass_ReadCCFile2, 6)
 			Includes::LoadedINIFiles.RemoveItem(j);
 		}
 		Includes::LastReadIndex = -1;
+
+		if(IniSectionIncludes::LogInheritance) {
+			IniSectionIncludes::LogInherited(xINI);
+		}
+
+		if(Hits || Misses || Uncached) {
+			Debug::Log("Includes: %u files merged from cache, %u parsed and "
+				"cached, %u parsed uncached. %u files cached in total, "
+				"using %u bytes.\n", Hits, Misses, Uncached, Cache.size(),
+				CacheMemory);
+			Hits = Misses = Uncached = 0;
+		}
 	}
 	return 0;
 }
@@ -10,4 +10,14 @@ public:
 	static int LastReadIndex;
 	static DynamicVectorClass<CCINIClass*> LoadedINIs;
 	static DynamicVectorClass<char*> LoadedINIFiles;
+
+	// reads an included file into the INI. the parsed sections and entries
+	// are kept for the lifetime of the process, up to a limit, and merged
+	// from there as long as the contents of the file do not change.
+	static void LoadInclude(CCINIClass* pINI, const char* pFilename);
+
+	// call if the contents parsed into the INI depend on what it contained
+	// before, like sections inheriting from other sections. such files are
+	// not cached.
+	static void DependsOnContents(CCINIClass* pINI);
 };
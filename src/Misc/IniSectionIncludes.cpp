@@ -1,22 +1,65 @@
 #include <GenericList.h>
 #include "Debug.h"
 #include "IniSectionIncludes.h"
+#include "Includes.h"
 
 #include <Helpers\Macro.h>
 
 INIClass::INISection* IniSectionIncludes::includedSection = nullptr;
+bool IniSectionIncludes::LogInheritance = false;
+std::vector<IniSectionIncludes::Inheritance> IniSectionIncludes::inherited;
+
+namespace
+{
+	bool IsEntry(GenericNode* node)
+	{
+		return *reinterpret_cast<unsigned int*>(node) == 0x7EB734; //type check via vtable address comparison... is there a better way?
+	}
+}
 
 void IniSectionIncludes::CopySection(CCINIClass* ini, INIClass::INISection* source, const char* destName)
 {
 	//browse through section entries and copy them over to the new section
 	for(GenericNode* node = &source->Entries.First; node; node = node->Next)
 	{
-		if(*reinterpret_cast<unsigned int*>(node) == 0x7EB734) //type check via vtable address comparison... is there a better way?
+		if(IsEntry(node))
 		{
 			INIClass::INIEntry* entry = static_cast<INIClass::INIEntry*>(node);
 			ini->WriteString(destName, entry->Key, entry->Value); //simple but effective
 		}
 	}
+
+	if(LogInheritance)
+	{
+		inherited.push_back(Inheritance{ ini, destName, source->Name });
+	}
+}
+
+void IniSectionIncludes::LogInherited(CCINIClass* ini)
+{
+	for(auto const& item : inherited)
+	{
+		if(item.INI != ini)
+		{
+			continue;
+		}
+
+		Debug::Log("[%s] inherits from [%s], resolved:\n", item.Derived.c_str(), item.Base.c_str());
+		if(auto section = ini->GetSection(item.Derived.c_str()))
+		{
+			for(GenericNode* node = &section->Entries.First; node; node = node->Next)
+			{
+				if(IsEntry(node))
+				{
+					INIClass::INIEntry* entry = static_cast<INIClass::INIEntry*>(node);
+					Debug::Log("\t%s = %s\n", entry->Key, entry->Value);
+				}
+			}
+		}
+	}
+
+	//INIs read while this one was read are done as well
+	inherited.clear();
 }
 
 CCINIClass::INISection* IniSectionIncludes::PreProcess(CCINIClass* ini, char* str)
@@ -26,6 +69,7 @@ CCINIClass::INISection* IniSectionIncludes::PreProcess(CCINIClass* ini, char* st
 	{
 		//inclusion operator detected, make sure there's a valid section definiton after that
 		*split++ = 0;
+		Includes::DependsOnContents(ini);
 		if(*split == '[')
 		{
 			split++;
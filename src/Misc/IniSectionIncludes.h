@@ -2,12 +2,30 @@
 
 #include <CCINIClass.h>
 
+#include <string>
+#include <vector>
+
 //temporary information holder
 class IniSectionIncludes
 {
 public:
 	static INIClass::INISection* includedSection;
 
+	//log the resolved entries of each inheriting section (-LOG-INHERITANCE)
+	static bool LogInheritance;
+
 	static CCINIClass::INISection* PreProcess(CCINIClass* ini, char* str);
 	static void CopySection(CCINIClass* ini, INIClass::INISection* source, const char* dest);
+
+	//logs the inheriting sections of an INI that has been read completely
+	static void LogInherited(CCINIClass* ini);
+
+private:
+	struct Inheritance {
+		CCINIClass* INI;
+		std::string Derived;
+		std::string Base;
+	};
+
+	static std::vector<Inheritance> inherited;
 };
@@ -4,11 +4,17 @@
 #include <GeneralStructures.h>
 
 #include "../Ext/Building/Body.h"
+#include "../Ext/Techno/Body.h"
 #include "../Ext/TechnoType/Body.h"
 #include "Debug.h"
 
 #include "../Utilities/TemplateDef.h"
 
+#include <algorithm>
+
+std::vector<BuildingClass*> JammerClass::Jammables;
+bool JammerClass::JammablesDirty = true;
+
 void JammerClass::Update() {
 	// we don't want to scan & crunch numbers every frame - this limits it to ScanInterval frames
 	if((Unsorted::CurrentFrame - this->LastScan) < this->ScanInterval) {
@@ -18,12 +24,28 @@ void JammerClass::Update() {
 	// save the current frame for future reference
 	this->LastScan = Unsorted::CurrentFrame;
 
-	// walk through all buildings
-	for(auto const& curBuilding : *BuildingClass::Array) {
+	// the index is not saved and not maintained while loading, so it has to
+	// be collected once from all buildings
+	if(JammablesDirty) {
+		Jammables.clear();
+		for(auto const& pBld : *BuildingClass::Array) {
+			if(pBld->IsOnMap && IsJammable(pBld)) {
+				Jammables.push_back(pBld);
+			}
+		}
+		JammablesDirty = false;
+	}
+
+	auto const pExt = TechnoTypeExt::ExtMap.Find(this->AttachedToObject->GetTechnoType());
+	auto const JamRadiusInLeptons = 256.0 * pExt->RadarJamRadius;
+	auto const RangeSquared = JamRadiusInLeptons * JamRadiusInLeptons;
+
+	// walk through all radars and spy satellites
+	for(auto const& curBuilding : Jammables) {
 		// for each jammable building ...
 		if(this->IsEligible(curBuilding)) {
 			// ...check if it's in range, and jam or unjam based on that
-			if(this->InRangeOf(curBuilding)) {
+			if(this->InRangeOf(curBuilding, RangeSquared)) {
 				this->Jam(curBuilding);
 			} else {
 				this->Unjam(curBuilding);
@@ -39,16 +61,20 @@ bool JammerClass::IsEligible(BuildingClass* TargetBuilding) {
 		- either a radar or a spysat
 	*/
 	return !this->AttachedToObject->Owner->IsAlliedWith(TargetBuilding->Owner)
-		&& (TargetBuilding->Type->Radar || TargetBuilding->Type->SpySat);
+		&& IsJammable(TargetBuilding);
 }
 
 //! \param TargetBuilding The building to check the distance to.
-bool JammerClass::InRangeOf(BuildingClass* TargetBuilding) {
-	auto const pExt = TechnoTypeExt::ExtMap.Find(this->AttachedToObject->GetTechnoType());
+//! \param RangeSquared The squared jam radius in leptons.
+bool JammerClass::InRangeOf(BuildingClass* TargetBuilding, double const RangeSquared) {
 	auto const& JammerLocation = this->AttachedToObject->Location;
-	auto const JamRadiusInLeptons = 256.0 * pExt->RadarJamRadius;
+	auto const& TargetLocation = TargetBuilding->Location;
+
+	auto const dx = static_cast<double>(TargetLocation.X - JammerLocation.X);
+	auto const dy = static_cast<double>(TargetLocation.Y - JammerLocation.Y);
+	auto const dz = static_cast<double>(TargetLocation.Z - JammerLocation.Z);
 
-	return TargetBuilding->Location.DistanceFrom(JammerLocation) <= JamRadiusInLeptons;
+	return dx * dx + dy * dy + dz * dz <= RangeSquared;
 }
 
 //! \param TargetBuilding The building to jam.
@@ -61,6 +87,15 @@ void JammerClass::Jam(BuildingClass* TargetBuilding) {
 			TargetBuilding->Owner->RecheckRadar = true;
 		}
 		this->Registered = true;
+
+		// changing the owner clears the building's jammers, so the building
+		// might still be listed here
+		auto const it = std::find(this->Jammed.begin(), this->Jammed.end(), TargetBuilding);
+		if(it == this->Jammed.end()) {
+			this->Jammed.push_back(TargetBuilding);
+			auto const pTechnoExt = TechnoExt::ExtMap.Find(this->AttachedToObject);
+			TechnoExt::ExtMap.Watch(pTechnoExt, TargetBuilding);
+		}
 	}
 }
 
@@ -74,22 +109,75 @@ void JammerClass::Unjam(BuildingClass* TargetBuilding) {
 			TargetBuilding->Owner->RecheckRadar = true;
 		}
 	}
+
+	auto const it = std::find(this->Jammed.begin(), this->Jammed.end(), TargetBuilding);
+	if(it != this->Jammed.end()) {
+		*it = this->Jammed.back();
+		this->Jammed.pop_back();
+	}
 }
 
 void JammerClass::UnjamAll() {
 	if(this->Registered) {
 		this->Registered = false;
-		for(auto const& item : *BuildingClass::Array) {
-			this->Unjam(item);
+
+		// Unjam removes the building from the list
+		while(!this->Jammed.empty()) {
+			this->Unjam(this->Jammed.back());
 		}
 	}
 }
 
+void JammerClass::InvalidatePointer(void* const ptr, bool const bRemoved) {
+	auto const it = std::find(this->Jammed.begin(), this->Jammed.end(), ptr);
+	if(it != this->Jammed.end()) {
+		if(bRemoved) {
+			// the building is gone, and its jammers with it
+			*it = this->Jammed.back();
+			this->Jammed.pop_back();
+		} else {
+			this->Unjam(*it);
+		}
+	}
+}
+
+bool JammerClass::IsJammable(BuildingClass* const pBuilding) {
+	return pBuilding->Type->Radar || pBuilding->Type->SpySat;
+}
+
+void JammerClass::RegisterBuilding(BuildingClass* const pBuilding) {
+	if(!JammablesDirty && IsJammable(pBuilding)) {
+		if(std::find(Jammables.begin(), Jammables.end(), pBuilding) == Jammables.end()) {
+			Jammables.push_back(pBuilding);
+		}
+	}
+}
+
+void JammerClass::UnregisterBuilding(BuildingClass* const pBuilding) {
+	auto const it = std::find(Jammables.begin(), Jammables.end(), pBuilding);
+	if(it != Jammables.end()) {
+		*it = Jammables.back();
+		Jammables.pop_back();
+	}
+}
+
+void JammerClass::Clear() {
+	Jammables.clear();
+	JammablesDirty = true;
+}
+
+void JammerClass::PointerGotInvalid(void* const ptr, bool const bRemoved) {
+	if(bRemoved) {
+		UnregisterBuilding(static_cast<BuildingClass*>(ptr));
+	}
+}
+
 bool JammerClass::Load(AresStreamReader &Stm, bool RegisterForChange) {
 	return Stm
 		.Process(this->LastScan)
 		.Process(this->AttachedToObject)
 		.Process(this->Registered)
+		.Process(this->Jammed, RegisterForChange)
 		.Success();
 }
 
@@ -98,5 +186,6 @@ bool JammerClass::Save(AresStreamWriter &Stm) const {
 		.Process(this->LastScan)
 		.Process(this->AttachedToObject)
 		.Process(this->Registered)
+		.Process(this->Jammed)
 		.Success();
 }
@@ -2,6 +2,8 @@
 
 #include "../Misc/Savegame.h"
 
+#include <vector>
+
 class TechnoClass;
 class BuildingClass;
 
@@ -14,7 +16,12 @@ class JammerClass {
 
 	bool Registered;						//!< Did I jam anything at all? Used to skip endless unjam calls.
 
-	bool InRangeOf(BuildingClass *);		//!< Calculates if the jammer is in range of this building.
+	std::vector<BuildingClass*> Jammed;		//!< The buildings this jammer is registered with.
+
+	static std::vector<BuildingClass*> Jammables;	//!< All radars and spy satellites on the map.
+	static bool JammablesDirty;				//!< Jammables has to be rebuilt from the building array.
+
+	bool InRangeOf(BuildingClass *, double RangeSquared);	//!< Calculates if the jammer is in range of this building.
 	bool IsEligible(BuildingClass *);		//!< Checks if this building can/should be jammed.
 
 	void Jam(BuildingClass *);				//!< Attempts to jam the given building. (Actually just registers the Jammer with it, the jamming happens in a hook.)
@@ -34,6 +41,18 @@ class JammerClass {
 	void UnjamAll();						//!< Unregisters this Jammer on all structures.
 	void Update();							//!< Updates this Jammer's status on all eligible structures.
 
+	void InvalidatePointer(void *ptr, bool bRemoved);	//!< Forgets a building this jammer is registered with.
+	std::vector<BuildingClass*> const& GetJammed() const {
+		return this->Jammed;
+	}
+
+	static bool IsJammable(BuildingClass *);			//!< Whether a building is a radar or spy satellite.
+	static void RegisterBuilding(BuildingClass *);		//!< Adds a building that was put on the map to Jammables.
+	static void UnregisterBuilding(BuildingClass *);	//!< Removes a building that left the map from Jammables.
+
+	static void Clear();
+	static void PointerGotInvalid(void *ptr, bool bRemoved);
+
 	bool Load(AresStreamReader &Stm, bool RegisterForChange);
 	bool Save(AresStreamWriter &Stm) const;
 };
@@ -24,9 +24,58 @@
 #include <HouseClass.h>
 
 #include "SavegameDef.h"
+#include "TechnoGrid.h"
 
 #include <algorithm>
 
+namespace {
+	// the largest range any of the techno types can have. if any is set,
+	// all techno types are considered. the result is kept in cache until
+	// the next ini is read.
+	template <typename Func>
+	int GetMaxRange(
+		int& cache, bool const any,
+		ValueableVector<TechnoTypeClass*> const& types, Func getRange)
+	{
+		if(cache >= 0) {
+			return cache;
+		}
+
+		auto ret = 0;
+		auto const check = [&ret, &getRange](TechnoTypeClass* const pType) {
+			auto const pExt = TechnoTypeExt::ExtMap.Find(pType);
+			ret = std::max(ret, getRange(pType, pExt));
+		};
+
+		if(any) {
+			std::for_each(TechnoTypeClass::Array->begin(), TechnoTypeClass::Array->end(), check);
+		} else {
+			std::for_each(types.begin(), types.end(), check);
+		}
+
+		cache = ret;
+		return ret;
+	}
+
+	// whether any techno near the cell is accepted by the predicate
+	template <typename Func>
+	bool AnyInCellRange(CellStruct const& Coords, int const range, Func pred) {
+		auto found = false;
+		auto const crd = CellClass::Cell2Coord(Coords);
+
+		// the distance is measured in cells, so add one to include partial
+		// cells at the edge
+		TechnoGrid::Instance.ForEachInRadius(crd, (range + 1) * 256,
+			[&found, &pred](TechnoClass* const pTechno)
+		{
+			found = pred(pTechno);
+			return !found;
+		});
+
+		return found;
+	}
+}
+
 #pragma region TargetingData definitions
 
 TargetingData::TargetingData(SWTypeExt::ExtData* pTypeExt, HouseClass* pOwner) noexcept
@@ -258,8 +307,15 @@ bool NewSWType::HasDesignator(SWTypeExt::ExtData* pSWType, HouseClass* pOwner, c
 		return true;
 	}
 
+	auto const range = GetMaxRange(
+		pSWType->SW_DesignatorsMaxRange, pSWType->SW_AnyDesignator,
+		pSWType->SW_Designators, [](TechnoTypeClass* pType, TechnoTypeExt::ExtData* pExt)
+	{
+		return pExt->DesignatorRange.Get(pType->Sight);
+	});
+
 	// a single designator in range suffices
-	return std::any_of(TechnoClass::Array->begin(), TechnoClass::Array->end(), [=, &Coords](TechnoClass* pTechno) {
+	return AnyInCellRange(Coords, range, [=, &Coords](TechnoClass* pTechno) {
 		return IsDesignatorEligible(pSWType, pOwner, Coords, pTechno);
 	});
 }
@@ -308,8 +364,15 @@ bool NewSWType::HasInhibitor(SWTypeExt::ExtData* pSWType, HouseClass* pOwner, co
 		return false;
 	}
 
+	auto const range = GetMaxRange(
+		pSWType->SW_InhibitorsMaxRange, pSWType->SW_AnyInhibitor,
+		pSWType->SW_Inhibitors, [](TechnoTypeClass* pType, TechnoTypeExt::ExtData* pExt)
+	{
+		return pExt->InhibitorRange.Get(pType->Sight);
+	});
+
 	// a single inhibitor in range suffices
-	return std::any_of(TechnoClass::Array->begin(), TechnoClass::Array->end(), [=, &Coords](TechnoClass* pTechno) {
+	return AnyInCellRange(Coords, range, [=, &Coords](TechnoClass* pTechno) {
 		return IsInhibitorEligible(pSWType, pOwner, Coords, pTechno);
 	});
 }
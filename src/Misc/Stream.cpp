@@ -6,28 +6,43 @@
 
 #include <Objidl.h>
 
-AresByteStream::AresByteStream(size_t Reserve) : Data(), CurrentOffset(0) {
+#include <algorithm>
+
+AresByteStream::AresByteStream(size_t Reserve) : Data(), Used(0), CurrentOffset(0) {
 	this->Data.reserve(Reserve);
 }
 
+AresByteStream::AresByteStream(AresByteStream&& other) noexcept :
+	Data(std::move(other.Data)), Used(other.Used), CurrentOffset(other.CurrentOffset)
+{
+	other.Used = 0;
+	other.CurrentOffset = 0;
+}
+
 AresByteStream::~AresByteStream() = default;
 
+AresByteStream& AresByteStream::operator =(AresByteStream&& other) noexcept {
+	AresByteStream(std::move(other)).swap(*this);
+	return *this;
+}
+
 bool AresByteStream::ReadFromStream(IStream *pStm, const size_t Length) {
 	ULONG out = 0;
-	auto size = this->Data.size();
-	this->Data.resize(size + Length);
-	auto pv = reinterpret_cast<void *>(this->Data.data());
+	if(this->Data.size() - this->Used < Length) {
+		this->Grow(Length);
+	}
+	auto pv = reinterpret_cast<void *>(this->Data.data() + this->Used);
 	auto success = pStm->Read(pv, Length, &out);
 	bool result(SUCCEEDED(success) && out == Length);
-	if(!result) {
-		this->Data.resize(size);
+	if(result) {
+		this->Used += Length;
 	}
 	return result;
 }
 
 bool AresByteStream::WriteToStream(IStream *pStm) const {
 	ULONG out = 0;
-	const size_t Length(this->Data.size());
+	const size_t Length(this->Used);
 	auto pcv = reinterpret_cast<const void *>(this->Data.data());
 	auto success = pStm->Write(pcv, Length, &out);
 	return SUCCEEDED(success) && out == Length;
@@ -35,7 +50,7 @@ bool AresByteStream::WriteToStream(IStream *pStm) const {
 
 bool AresByteStream::Read(data_t* Value, size_t Size) {
 	bool ret = false;
-	if(this->Data.size() >= this->CurrentOffset + Size) {
+	if(this->Used >= this->CurrentOffset + Size) {
 		auto Position = &this->Data[this->CurrentOffset];
 		std::memcpy(Value, Position, Size);
 		ret = true;
@@ -45,8 +60,10 @@ bool AresByteStream::Read(data_t* Value, size_t Size) {
 	return ret;
 }
 
-void AresByteStream::Write(const data_t* Value, size_t Size) {
-	this->Data.insert(this->Data.end(), Value, Value + Size);
+void AresByteStream::Grow(size_t Size) {
+	auto const required = this->Used + Size;
+	auto capacity = std::max(this->Data.capacity(), this->Data.size() * 2);
+	this->Data.resize(std::max(capacity, required));
 }
 
 size_t AresByteStream::ReadBlockFromStream(IStream *pStm) {
@@ -62,7 +79,7 @@ size_t AresByteStream::ReadBlockFromStream(IStream *pStm) {
 
 bool AresByteStream::WriteBlockToStream(IStream *pStm) const {
 	ULONG out = 0;
-	const size_t Length = this->Data.size();
+	const size_t Length = this->Used;
 	if(SUCCEEDED(pStm->Write(&Length, sizeof(Length), &out))) {
 		return this->WriteToStream(pStm);
 	}
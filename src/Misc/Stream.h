@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstring>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 struct IStream;
@@ -9,21 +11,41 @@ class AresByteStream {
 public:
 	using data_t = unsigned char;
 protected:
+	// the storage. only the first Used bytes are valid, the rest is room
+	// for writing without having to reallocate
 	std::vector<data_t> Data;
+	size_t Used;
 	size_t CurrentOffset;
 public:
 	AresByteStream(size_t Reserve = 0x1000);
+	AresByteStream(AresByteStream const&) = default;
+	AresByteStream(AresByteStream&& other) noexcept;
 
 	~AresByteStream();
 
+	AresByteStream& operator =(AresByteStream const&) = default;
+	AresByteStream& operator =(AresByteStream&& other) noexcept;
+
+	// exchanges storage and state, used to release the memory
+	void swap(AresByteStream& other) noexcept {
+		using std::swap;
+		swap(this->Data, other.Data);
+		swap(this->Used, other.Used);
+		swap(this->CurrentOffset, other.CurrentOffset);
+	}
+
 	size_t Size() const {
-		return this->Data.size();
+		return this->Used;
 	}
 
 	size_t Offset() const {
 		return this->CurrentOffset;
 	}
 
+	const data_t* Raw() const {
+		return this->Data.data();
+	}
+
 	/**
 	* reads {Length} bytes from {pStm} into its storage
 	*/
@@ -45,6 +67,14 @@ public:
 	*/
 	bool WriteBlockToStream(IStream *pStm) const;
 
+	/**
+	* discards the contents but keeps the storage, so the stream can be
+	* reused as scratch buffer without allocating again
+	*/
+	void Reset() {
+		this->Used = 0;
+		this->CurrentOffset = 0;
+	}
 
 	// primitive save/load - should not be specialized
 
@@ -58,7 +88,13 @@ public:
 	* ensures there are at least {Size} bytes left in the internal storage, and assigns {Value} casted to byte to that buffer
 	* moves the internal position forward
 	*/
-	void Write(const data_t* Value, size_t Size);
+	void Write(const data_t* Value, size_t Size) {
+		if(this->Data.size() - this->Used < Size) {
+			this->Grow(Size);
+		}
+		std::memcpy(this->Data.data() + this->Used, Value, Size);
+		this->Used += Size;
+	}
 
 
 	/**
@@ -80,6 +116,12 @@ public:
 		auto Bytes = &reinterpret_cast<const data_t&>(Value);
 		this->Write(Bytes, sizeof(T));
 	};
+
+private:
+	/**
+	* makes room for at least {Size} more bytes, growing geometrically
+	*/
+	void Grow(size_t Size);
 };
 
 class AresStreamWorkerBase {
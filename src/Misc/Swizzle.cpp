@@ -1,14 +1,17 @@
 #include "Swizzle.h"
 
 #include "../Ares.h"
+#include "../Utilities/Stopwatch.h"
 #include "Debug.h"
 
+#include <algorithm>
+
 AresSwizzle AresSwizzle::Instance;
 
 HRESULT AresSwizzle::RegisterForChange(void **p) {
 	if(p) {
 		if(auto deref = *p) {
-			this->Nodes.emplace(deref, p);
+			this->Nodes.emplace_back(deref, p);
 			*p = nullptr;
 		}
 		return S_OK;
@@ -17,38 +20,55 @@ HRESULT AresSwizzle::RegisterForChange(void **p) {
 }
 
 HRESULT AresSwizzle::RegisterChange(void *was, void *is) {
-	auto exist = this->Changes.find(was);
-	if(exist == this->Changes.end()) {
-		this->Changes[was] = is;
-	} else if(exist->second != is) {
-		Debug::Log(Debug::Severity::Fatal, "Pointer %p declared change to both %p AND %p!\n", was, exist->second, is);
-	}
+	// duplicates are detected when the nodes are converted
+	this->Changes.emplace_back(was, is);
 	return S_OK;
 }
 
-void AresSwizzle::ConvertNodes() const {
-	Debug::Log("Converting %u nodes.\n", this->Nodes.size());
-	void *lastFind(nullptr);
-	void *lastRes(nullptr);
-	for(auto it = this->Nodes.begin(); it != this->Nodes.end(); ++it) {
-		if(lastFind != it->first) {
-			auto change = this->Changes.find(it->first);
-			if(change == this->Changes.end()) {
-				Debug::Log(Debug::Severity::Fatal, "Pointer %p could not be remapped!\n", it->first);
-			} else {
-				lastFind = it->first;
-				lastRes = change->second;
-			}
+void AresSwizzle::ConvertNodes() {
+	Stopwatch timer;
+
+	auto const byOld = [](auto const& lhs, auto const& rhs) {
+		return lhs.first < rhs.first;
+	};
+
+	// stable, so the first declared change wins, like it always did
+	std::stable_sort(this->Changes.begin(), this->Changes.end(), byOld);
+	std::sort(this->Nodes.begin(), this->Nodes.end(), byOld);
+
+	auto const changesEnd = this->Changes.cend();
+
+	for(auto it = this->Changes.cbegin(); it != changesEnd; ++it) {
+		auto const next = it + 1;
+		if(next != changesEnd && next->first == it->first && next->second != it->second) {
+			Debug::Log(Debug::Severity::Fatal, "Pointer %p declared change to both %p AND %p!\n", it->first, it->second, next->second);
 		}
-		if(auto p = it->second) {
-			*p = lastRes;
+	}
+
+	auto change = this->Changes.cbegin();
+
+	for(auto it = this->Nodes.cbegin(); it != this->Nodes.cend(); ++it) {
+		while(change != changesEnd && change->first < it->first) {
+			++change;
+		}
+
+		if(change != changesEnd && change->first == it->first) {
+			if(auto p = it->second) {
+				*p = change->second;
+			}
+		} else {
+			Debug::Log(Debug::Severity::Fatal, "Pointer %p could not be remapped!\n", it->first);
 		}
 	}
+
+	Debug::Log("Converted %u nodes using %u changes in %.3f ms.\n",
+		this->Nodes.size(), this->Changes.size(), timer.ElapsedMilliseconds());
 }
 
 void AresSwizzle::Clear() {
-	this->Nodes.clear();
-	this->Changes.clear();
+	// release the memory, there is no use for it until the next load
+	decltype(this->Nodes)().swap(this->Nodes);
+	decltype(this->Changes)().swap(this->Changes);
 }
 
 DEFINE_HOOK(6CF350, SwizzleManagerClass_ConvertNodes, 0)
@@ -1,7 +1,8 @@
 #pragma once
 
-#include <unordered_map>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <Objidl.h>
 
@@ -16,18 +17,20 @@
 *  this system handles that: you use RegisterForChange(&ptr) to say "this is a pointer to a pointer that needs to be updated"
 *  and RegisterChange(oldPtr, this) to say "what was at address oldPtr is now at address this"
 *  once the loading is complete, ConvertNodes will go over the registered nodes and replace pointers it knows about
+*
+* both are only appended to while loading. ConvertNodes sorts them once and resolves all nodes in a single merge pass.
 */
 class AresSwizzle {
 protected:
 	/**
-	* data store for RegisterChange
+	* data store for RegisterChange, pairs of old and new pointer
 	*/
-	std::unordered_map<void *, void *> Changes;
+	std::vector<std::pair<void *, void *>> Changes;
 
 	/**
-	* data store for RegisterForChange
+	* data store for RegisterForChange, pairs of old pointer and the address it was stored at
 	*/
-	std::unordered_multimap<void *, void **> Nodes;
+	std::vector<std::pair<void *, void **>> Nodes;
 
 public:
 	static AresSwizzle Instance;
@@ -50,7 +53,7 @@ public:
 	/**
 	* this function will rewrite all registered nodes' values
 	*/
-	void ConvertNodes() const;
+	void ConvertNodes();
 
 	void Clear();
 
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+
+// the binary synchronization log written with -BINARYSYNC and read by the
+// desync diff tool in tools/syncdiff. this header must not depend on the
+// game, so the tool can include it on any platform.
+//
+// the file starts with a Header, followed by the classes, frames, types and
+// objects, one fixed size record each, in this order. all values are little
+// endian.
+namespace SyncLog
+{
+	static const char Magic[8] = { 'A', 'R', 'E', 'S', 'S', 'Y', 'N', 'C' };
+	static const uint32_t Version = 1;
+
+	// the list an object record was taken from
+	enum class List : uint8_t {
+		Houses = 0,
+		Abstracts = 1
+	};
+
+#pragma pack(push, 1)
+	struct Header {
+		char Magic[8];
+		uint32_t Version;
+		char AresVersion[32];
+
+		int32_t Frame;
+		uint32_t Random;
+		int32_t PlayerIndex;
+
+		uint8_t HasEvent;
+		uint8_t Reserved[3];
+		int32_t EventKind;
+		int32_t EventFrame;
+		int32_t EventHouse;
+		uint32_t EventChecksum;
+
+		uint32_t ClassCount;
+		uint32_t FrameCount;
+		uint32_t TypeCount;
+		uint32_t ObjectCount;
+	};
+
+	// the name of an AbstractType, so the tool does not need to know them
+	struct ClassRecord {
+		uint8_t What;
+		char Name[31];
+	};
+
+	// the checksum the game calculated for one of the recent frames
+	struct FrameRecord {
+		int32_t Frame;
+		uint32_t CRC;
+	};
+
+	// one entry of AbstractTypeClass::Array
+	struct TypeRecord {
+		uint8_t What;
+		uint8_t Reserved[3];
+		int32_t Index;
+		uint32_t Checksum;
+		char ID[24];
+	};
+
+	// one house or abstract. for houses, the type is the HouseType and the
+	// value is the money, for objects it is the health.
+	struct ObjectRecord {
+		uint8_t List;
+		uint8_t What;
+		uint8_t TypeWhat;
+		uint8_t InLimbo;
+		int32_t Index;
+		uint32_t UniqueID;
+		uint32_t Checksum;
+		int32_t TypeIndex;
+		int32_t X;
+		int32_t Y;
+		int32_t Z;
+		int32_t Value;
+	};
+#pragma pack(pop)
+
+	static_assert(sizeof(Header) == 92, "SyncLog::Header changed size");
+	static_assert(sizeof(ClassRecord) == 32, "SyncLog::ClassRecord changed size");
+	static_assert(sizeof(FrameRecord) == 8, "SyncLog::FrameRecord changed size");
+	static_assert(sizeof(TypeRecord) == 36, "SyncLog::TypeRecord changed size");
+	static_assert(sizeof(ObjectRecord) == 36, "SyncLog::ObjectRecord changed size");
+}
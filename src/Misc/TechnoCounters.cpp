@@ -0,0 +1,213 @@
+#include "TechnoCounters.h"
+
+#include "../Ares.h"
+#include "../Ext/Techno/Body.h"
+#include "../Ext/TechnoType/Body.h"
+
+#include <HouseClass.h>
+#include <UnitClass.h>
+
+#include <algorithm>
+
+std::vector<TechnoClass*> TechnoCounters::Hijacked;
+bool TechnoCounters::Valid = false;
+
+int TechnoCounters::CountExisting(TechnoTypeClass const* const pType) {
+	EnsureValid();
+
+	auto const pExt = TechnoTypeExt::ExtMap.Find(pType);
+	return pExt ? pExt->LiveCount : 0;
+}
+
+int TechnoCounters::CountHijackedBy(
+	HouseClass const* const pHouse, InfantryTypeClass const* const pType)
+{
+	EnsureValid();
+
+	auto const index = pType->ArrayIndex;
+	return static_cast<int>(std::count_if(Hijacked.begin(), Hijacked.end(),
+		[pHouse, index](TechnoClass* pTechno)
+	{
+		return pTechno->HijackerInfantryType == index
+			&& pTechno->Owner == pHouse
+			&& pTechno->WhatAmI() == AbstractType::Unit;
+	}));
+}
+
+int TechnoCounters::CountOwned(
+	HouseClass const* const pHouse, TechnoTypeClass const* const pType)
+{
+	EnsureValid();
+
+	auto const pExt = TechnoTypeExt::ExtMap.Find(pType);
+	auto const index = static_cast<size_t>(pHouse->ArrayIndex);
+	return (pExt && index < pExt->OwnedCounts.size()) ? pExt->OwnedCounts[index] : 0;
+}
+
+void TechnoCounters::Add(TechnoClass* const pTechno) {
+	// everything is counted when the counters are collected
+	if(Valid) {
+		Count(pTechno, pTechno->Owner);
+	}
+}
+
+void TechnoCounters::Remove(TechnoClass* const pTechno) {
+	if(!Valid) {
+		return;
+	}
+
+	Uncount(pTechno);
+
+	auto const it = std::find(Hijacked.begin(), Hijacked.end(), pTechno);
+	if(it != Hijacked.end()) {
+		Hijacked.erase(it);
+	}
+}
+
+void TechnoCounters::UpdateType(TechnoClass* const pTechno) {
+	auto const pExt = TechnoExt::ExtMap.Find(pTechno);
+	if(Valid && pExt && pExt->CountedType != pTechno->GetTechnoType()) {
+		Uncount(pTechno);
+		Count(pTechno, pTechno->Owner);
+	}
+}
+
+void TechnoCounters::UpdateOwner(
+	TechnoClass* const pTechno, HouseClass* const pNewOwner)
+{
+	if(Valid) {
+		Uncount(pTechno);
+		Count(pTechno, pNewOwner);
+	}
+}
+
+void TechnoCounters::Count(TechnoClass* const pTechno, HouseClass* const pOwner) {
+	auto const pExt = TechnoExt::ExtMap.Find(pTechno);
+	if(!pExt || pExt->CountedType) {
+		return;
+	}
+
+	if(auto const pType = pTechno->GetTechnoType()) {
+		auto const pTypeExt = TechnoTypeExt::ExtMap.Find(pType);
+		pExt->CountedType = pType;
+		++pTypeExt->LiveCount;
+
+		if(pOwner) {
+			auto const index = static_cast<size_t>(pOwner->ArrayIndex);
+			auto& counts = pTypeExt->OwnedCounts;
+			if(index >= counts.size()) {
+				counts.resize(index + 1);
+			}
+			pExt->CountedOwner = pOwner->ArrayIndex;
+			++counts[index];
+		}
+	}
+}
+
+void TechnoCounters::Uncount(TechnoClass* const pTechno) {
+	auto const pExt = TechnoExt::ExtMap.Find(pTechno);
+	if(!pExt || !pExt->CountedType) {
+		return;
+	}
+
+	auto const pTypeExt = TechnoTypeExt::ExtMap.Find(pExt->CountedType);
+	--pTypeExt->LiveCount;
+
+	// the owner was counted when the type was, so the entry exists
+	if(pExt->CountedOwner >= 0) {
+		--pTypeExt->OwnedCounts[static_cast<size_t>(pExt->CountedOwner)];
+	}
+
+	pExt->CountedType = nullptr;
+	pExt->CountedOwner = -1;
+}
+
+void TechnoCounters::UpdateHijacked(TechnoClass* const pTechno) {
+	if(!Valid) {
+		return;
+	}
+
+	auto const it = std::find(Hijacked.begin(), Hijacked.end(), pTechno);
+	auto const listed = it != Hijacked.end();
+
+	if(pTechno->HijackerInfantryType != -1) {
+		if(!listed) {
+			Hijacked.push_back(pTechno);
+		}
+	} else if(listed) {
+		Hijacked.erase(it);
+	}
+}
+
+void TechnoCounters::Invalidate() {
+	Valid = false;
+}
+
+void TechnoCounters::EnsureValid() {
+	if(Valid) {
+		return;
+	}
+
+	for(auto const& pType : *TechnoTypeClass::Array) {
+		if(auto const pExt = TechnoTypeExt::ExtMap.Find(pType)) {
+			pExt->LiveCount = 0;
+			pExt->OwnedCounts.clear();
+		}
+	}
+
+	Hijacked.clear();
+
+	// Add and Remove do nothing while the counters are invalid
+	Valid = true;
+
+	for(auto const& pTechno : *TechnoClass::Array) {
+		if(auto const pExt = TechnoExt::ExtMap.Find(pTechno)) {
+			pExt->CountedType = nullptr;
+			pExt->CountedOwner = -1;
+		}
+		Add(pTechno);
+	}
+
+	for(auto const& pUnit : *UnitClass::Array) {
+		if(pUnit->HijackerInfantryType != -1) {
+			Hijacked.push_back(pUnit);
+		}
+	}
+}
+
+void TechnoCounters::Clear() {
+	Hijacked.clear();
+	Valid = false;
+}
+
+void TechnoCounters::PointerGotInvalid(void* const ptr, bool const removed) {
+	if(removed && !Hijacked.empty()) {
+		auto const it = std::find(Hijacked.begin(), Hijacked.end(), ptr);
+		if(it != Hijacked.end()) {
+			Hijacked.erase(it);
+		}
+	}
+}
+
+// count the technos as soon as their type is known
+
+DEFINE_HOOK_AGAIN(517D51, TechnoClass_Init_TechnoCounters, 6) // Infantry
+DEFINE_HOOK_AGAIN(735678, TechnoClass_Init_TechnoCounters, 6) // Unit, inlined in CTOR
+DEFINE_HOOK_AGAIN(74689B, TechnoClass_Init_TechnoCounters, 6) // Unit
+DEFINE_HOOK_AGAIN(413FD2, TechnoClass_Init_TechnoCounters, 6) // Aircraft
+DEFINE_HOOK(442D1B, TechnoClass_Init_TechnoCounters, 6) // Building
+{
+	GET(TechnoClass*, pThis, ESI);
+	TechnoCounters::Add(pThis);
+	return 0;
+}
+
+// count the technos for their new owner
+
+DEFINE_HOOK(7015EB, TechnoClass_ChangeOwnership_TechnoCounters, 7)
+{
+	GET(TechnoClass* const, pThis, ESI);
+	GET(HouseClass* const, pNewOwner, EBP);
+	TechnoCounters::UpdateOwner(pThis, pNewOwner);
+	return 0;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+
+class HouseClass;
+class InfantryTypeClass;
+class TechnoClass;
+class TechnoTypeClass;
+
+// counts how many objects of each techno type exist, in total and for each
+// house, and remembers which vehicles have been hijacked, so nobody has to
+// walk the object arrays for that.
+//
+// technos are counted when they are initialized, recounted when they change
+// owner and uncounted when they are destroyed. neither the counts nor the
+// hijacked vehicles are saved, they are collected from the object arrays the
+// first time they are needed after a scenario was cleared or a game was
+// loaded.
+class TechnoCounters
+{
+public:
+	// the number of technos of this type currently in TechnoClass::Array
+	static int CountExisting(TechnoTypeClass const* pType);
+
+	// the number of technos of this type the house owns
+	static int CountOwned(HouseClass const* pHouse, TechnoTypeClass const* pType);
+
+	// the number of the house's vehicles hijacked by this infantry type
+	static int CountHijackedBy(HouseClass const* pHouse, InfantryTypeClass const* pType);
+
+	static void Add(TechnoClass* pTechno);
+	static void Remove(TechnoClass* pTechno);
+
+	// call after changing the type of an existing techno
+	static void UpdateType(TechnoClass* pTechno);
+
+	// call when an existing techno changes its owner to pNewOwner
+	static void UpdateOwner(TechnoClass* pTechno, HouseClass* pNewOwner);
+
+	// call after setting or resetting a vehicle's HijackerInfantryType
+	static void UpdateHijacked(TechnoClass* pTechno);
+
+	static void Invalidate();
+
+	static void Clear();
+	static void PointerGotInvalid(void* ptr, bool removed);
+
+private:
+	static void EnsureValid();
+
+	static void Count(TechnoClass* pTechno, HouseClass* pOwner);
+	static void Uncount(TechnoClass* pTechno);
+
+	static std::vector<TechnoClass*> Hijacked;
+	static bool Valid;
+};
@@ -0,0 +1,173 @@
+#include "TechnoGrid.h"
+
+#include "../Ares.h"
+#include "../Ext/Techno/Body.h"
+#include "../Utilities/Stopwatch.h"
+
+#include <BuildingTypeClass.h>
+#include <MapClass.h>
+#include <Unsorted.h>
+
+#include <algorithm>
+
+TechnoGrid TechnoGrid::Instance;
+
+TechnoGrid::TechnoGrid() : Entries(),
+	Buckets(),
+	Width(0),
+	Height(0),
+	Padding(0),
+	Frame(-1),
+	Dirty(true),
+	Queries(0),
+	Rebuilds(0),
+	Refreshes(0),
+	Moves(0),
+	Visited(0),
+	Returned(0),
+	FullScans(0),
+	RebuildTime(0.0),
+	RefreshTime(0.0)
+{ }
+
+void TechnoGrid::Update() {
+	if(this->Dirty) {
+		this->Rebuild();
+	} else if(this->Frame != Unsorted::CurrentFrame) {
+		this->Refresh();
+	}
+}
+
+void TechnoGrid::Rebuild() {
+	Stopwatch timer;
+
+	for(auto const& entry : this->Entries) {
+		TechnoExt::ExtMap.Find(entry.Techno)->GridIndex = -1;
+	}
+
+	this->Entries.clear();
+	this->Buckets.clear();
+
+	this->Frame = Unsorted::CurrentFrame;
+	this->Dirty = false;
+	++this->Rebuilds;
+
+	// cover the whole map. objects outside go to the buckets at the edge
+	auto const& Bounds = MapClass::Instance->MapCoordBounds;
+	this->Width = std::max(Bounds.Right / BucketCells + 1, 1);
+	this->Height = std::max(Bounds.Bottom / BucketCells + 1, 1);
+	this->Buckets.resize(static_cast<size_t>(this->Width * this->Height));
+
+	// the largest foundation, in cells
+	auto foundation = 0;
+	for(auto const& pType : *BuildingTypeClass::Array) {
+		foundation = std::max(foundation, pType->GetFoundationWidth());
+		foundation = std::max(foundation, pType->GetFoundationHeight(false));
+	}
+	this->Padding = (foundation + 1) * 256;
+
+	// the ones in the same bucket keep the order of the techno array
+	for(auto const& pTechno : *TechnoClass::Array) {
+		if(!pTechno->InLimbo) {
+			this->Insert(pTechno, this->GetBucket(pTechno->Location));
+		}
+	}
+
+	this->RebuildTime += timer.ElapsedMilliseconds();
+}
+
+void TechnoGrid::Refresh() {
+	Stopwatch timer;
+
+	this->Frame = Unsorted::CurrentFrame;
+	++this->Refreshes;
+
+	// move the technos that left their bucket
+	for(auto& entry : this->Entries) {
+		auto const bucket = this->GetBucket(entry.Techno->Location);
+		if(bucket != entry.Bucket) {
+			auto& items = this->Buckets[static_cast<size_t>(entry.Bucket)];
+			items.erase(std::find(items.begin(), items.end(), entry.Techno));
+			this->Buckets[static_cast<size_t>(bucket)].push_back(entry.Techno);
+			entry.Bucket = bucket;
+			++this->Moves;
+		}
+	}
+
+	this->RefreshTime += timer.ElapsedMilliseconds();
+}
+
+void TechnoGrid::Add(TechnoClass* const pTechno) {
+	if(!this->Dirty) {
+		auto const pExt = TechnoExt::ExtMap.Find(pTechno);
+		if(pExt->GridIndex < 0) {
+			this->Insert(pTechno, this->GetBucket(pTechno->Location));
+		}
+	}
+}
+
+void TechnoGrid::Remove(TechnoClass* const pTechno) {
+	// also done while dirty, so no deleted techno stays in the grid
+	auto const pExt = TechnoExt::ExtMap.Find(pTechno);
+	if(pExt && pExt->GridIndex >= 0) {
+		auto const index = static_cast<size_t>(pExt->GridIndex);
+		if(index >= this->Entries.size() || this->Entries[index].Techno != pTechno) {
+			Debug::Log("TechnoGrid: %p has no entry %u.\n", pTechno, index);
+			pExt->GridIndex = -1;
+			return;
+		}
+
+		this->Erase(pTechno, this->Entries[index].Bucket);
+
+		// fill the gap with the last entry
+		auto const& last = this->Entries.back();
+		TechnoExt::ExtMap.Find(last.Techno)->GridIndex = pExt->GridIndex;
+		this->Entries[index] = last;
+		this->Entries.pop_back();
+		pExt->GridIndex = -1;
+	}
+}
+
+void TechnoGrid::Insert(TechnoClass* const pTechno, int const bucket) {
+	TechnoExt::ExtMap.Find(pTechno)->GridIndex = static_cast<int>(this->Entries.size());
+	this->Entries.push_back({pTechno, bucket});
+	this->Buckets[static_cast<size_t>(bucket)].push_back(pTechno);
+}
+
+void TechnoGrid::Erase(TechnoClass* const pTechno, int const bucket) {
+	auto& items = this->Buckets[static_cast<size_t>(bucket)];
+	items.erase(std::find(items.begin(), items.end(), pTechno));
+}
+
+void TechnoGrid::LogStatistics() const {
+	if(this->Queries) {
+		Debug::Log("TechnoGrid: %u queries, %u rebuilds (%.3f ms), %u updates "
+			"(%.3f ms) moving %llu technos. Visited %llu candidates, returned "
+			"%llu, full scans would have visited %llu.\n", this->Queries,
+			this->Rebuilds, this->RebuildTime, this->Refreshes,
+			this->RefreshTime, this->Moves, this->Visited, this->Returned,
+			this->FullScans);
+	}
+}
+
+void TechnoGrid::Clear() {
+	Instance.LogStatistics();
+	Instance = TechnoGrid();
+}
+
+// technos entering or leaving the map change the grid
+
+DEFINE_HOOK_AGAIN(6F6F20, TechnoClass_Put_TechnoGrid, 6)
+DEFINE_HOOK(6F6D0E, TechnoClass_Put_TechnoGrid, 7)
+{
+	GET(TechnoClass*, pThis, ESI);
+	TechnoGrid::Instance.Add(pThis);
+	return 0;
+}
+
+DEFINE_HOOK(6F6AC9, TechnoClass_Remove_TechnoGrid, 6)
+{
+	GET(TechnoClass*, pThis, ESI);
+	TechnoGrid::Instance.Remove(pThis);
+	return 0;
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <GeneralStructures.h>
+#include <TechnoClass.h>
+
+#include <vector>
+
+// all technos on the map, sorted into square buckets of BucketCells cells.
+// technos are added when put on the map and removed when they are put into
+// limbo or deleted. there is no single place where objects move, so the
+// first query in a frame moves the technos whose bucket changed since the
+// last frame. the grid is only rebuilt from TechnoClass::Array after a
+// scenario was cleared or a game was loaded.
+//
+// buildings are sorted by their location, but their foundation can reach
+// a few cells beyond. objects also move after the update in the same frame.
+// so all queries are padded by one cell plus the largest foundation.
+class TechnoGrid
+{
+public:
+	static const int BucketCells = 8;
+	static const int BucketSize = BucketCells * 256;
+
+	static TechnoGrid Instance;
+
+	TechnoGrid();
+
+	// invokes func for every techno not in limbo whose location is within
+	// range leptons (horizontally) of coords, plus the padding. callers
+	// still have to do their own exact range check. if func returns false,
+	// the iteration stops.
+	template <typename Func>
+	void ForEachInRadius(CoordStruct const& coords, int range, Func&& func) {
+		this->Update();
+
+		++this->Queries;
+		this->FullScans += static_cast<unsigned int>(TechnoClass::Array->Count);
+
+		auto const padded = range + this->Padding;
+		auto const paddedSquared = static_cast<long long>(padded) * padded;
+
+		auto const x0 = this->BucketX(coords.X - padded);
+		auto const x1 = this->BucketX(coords.X + padded);
+		auto const y0 = this->BucketY(coords.Y - padded);
+		auto const y1 = this->BucketY(coords.Y + padded);
+
+		for(auto y = y0; y <= y1; ++y) {
+			for(auto x = x0; x <= x1; ++x) {
+				auto const& bucket = this->Buckets[static_cast<size_t>(y * this->Width + x)];
+
+				for(auto const& pTechno : bucket) {
+					++this->Visited;
+
+					auto const& location = pTechno->Location;
+					auto const dx = static_cast<long long>(location.X - coords.X);
+					auto const dy = static_cast<long long>(location.Y - coords.Y);
+
+					if(dx * dx + dy * dy <= paddedSquared) {
+						++this->Returned;
+						if(!func(pTechno)) {
+							return;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	// a techno has been put on the map, or was removed from it or deleted
+	void Add(TechnoClass* pTechno);
+	void Remove(TechnoClass* pTechno);
+
+	void LogStatistics() const;
+
+	static void Clear();
+
+private:
+	struct Entry {
+		TechnoClass* Techno;
+		int Bucket;
+	};
+
+	void Update();
+	void Rebuild();
+	void Refresh();
+
+	int GetBucket(CoordStruct const& coords) const {
+		return this->BucketY(coords.Y) * this->Width + this->BucketX(coords.X);
+	}
+
+	int BucketX(int const x) const {
+		return Clamp(x / BucketSize, this->Width);
+	}
+
+	int BucketY(int const y) const {
+		return Clamp(y / BucketSize, this->Height);
+	}
+
+	static int Clamp(int const value, int const count) {
+		return value < 0 ? 0 : (value >= count ? count - 1 : value);
+	}
+
+	void Insert(TechnoClass* pTechno, int bucket);
+	void Erase(TechnoClass* pTechno, int bucket);
+
+	// all technos on the grid with the bucket they are in. the techno
+	// extension knows the index of its entry.
+	std::vector<Entry> Entries;
+	std::vector<std::vector<TechnoClass*>> Buckets;
+
+	int Width;
+	int Height;
+	int Padding;
+
+	int Frame;
+	bool Dirty;
+
+	// how many candidates the queries looked at, and how many technos a
+	// full scan of TechnoClass::Array would have looked at instead
+	unsigned int Queries;
+	unsigned int Rebuilds;
+	unsigned int Refreshes;
+	unsigned long long Moves;
+	unsigned long long Visited;
+	unsigned long long Returned;
+	unsigned long long FullScans;
+
+	// time spent keeping the grid up to date, in milliseconds
+	double RebuildTime;
+	double RefreshTime;
+};
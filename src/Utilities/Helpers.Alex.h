@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../Misc/Debug.h"
+#include "../Misc/TechnoGrid.h"
 
 #include <BuildingClass.h>
 #include <BuildingTypeClass.h>
@@ -162,14 +163,16 @@ namespace Helpers {
 			// flying objects are not included normally
 			if(includeInAir) {
 				// the not quite so fast way. skip everything not in the air.
-				for(auto const& pTechno : *TechnoClass::Array) {
+				auto const range = static_cast<int>(spread * 256);
+				TechnoGrid::Instance.ForEachInRadius(coords, range, [&](TechnoClass* pTechno) {
 					if(pTechno->GetHeight() > 0) {
 						// rough estimation
 						if(pTechno->Location.DistanceFrom(coords) <= spread * 256) {
 							set.insert(pTechno);
 						}
 					}
-				}
+					return true;
+				});
 			}
 
 			// look closer. the final selection. put all affected items in a vector.
@@ -1,5 +1,9 @@
 #pragma once
 
+#include "ParserDetail.h"
+
+#include <cstring>
+
 //! Parses strings into one or more elements of another type.
 /*!
     \tparam T The type to convert to.
@@ -29,34 +33,37 @@ public:
 		\date 2013-03-10
 	*/
 	static size_t Parse(const char* pValue, OutType* outValue) {
-		char buffer[0x80];
 		for(size_t i=0; i<Count; ++i) {
 			// skip the leading spaces
-			while(isspace(static_cast<unsigned char>(*pValue))) {
+			while(ParserDetail::IsSpace(*pValue)) {
 				++pValue;
 			}
 
-			// read the next part
-			int n = 0;
-			if(sscanf_s(pValue, "%[^,]%n", buffer, sizeof(buffer), &n) != 1) {
+			// find the end of the next part
+			auto pEnd = pValue;
+			while(*pEnd && *pEnd != ',') {
+				++pEnd;
+			}
+
+			if(pEnd == pValue) {
 				return i;
 			}
 
 			// skip all read chars and the comma
-			pValue += n;
-			if(*pValue) {
-				++pValue;
-			}
+			auto const pNext = *pEnd ? pEnd + 1 : pEnd;
 
 			// trim the trailing spaces
-			while(n && isspace(static_cast<unsigned char>(buffer[n-1]))) {
-				buffer[n-- - 1] = '\0';
+			while(pEnd != pValue && ParserDetail::IsSpace(pEnd[-1])) {
+				--pEnd;
 			}
 
 			// interprete the value
-			if(!Parser<OutType>::TryParse(buffer, &outValue[i])) {
+			auto const length = static_cast<size_t>(pEnd - pValue);
+			if(!Parser<OutType>::TryParsePart(pValue, length, &outValue[i])) {
 				return i;
 			}
+
+			pValue = pNext;
 		}
 
 		return Count;
@@ -143,6 +150,29 @@ public:
 		}
 		return false;
 	}
+
+	//! Tries to parse a single element that is part of a larger string.
+	/*!
+		The element does not need to be terminated. Numeric specializations
+		parse it in place, the others copy it into a terminated buffer.
+
+		\param pValue The start of the element.
+		\param length The number of chars of the element.
+		\param outValue Optional pointer to the target memory.
+
+		\returns true, if the element could be parsed, false otherwise.
+	*/
+	static bool TryParsePart(const char* pValue, size_t length, OutType* outValue) {
+		char buffer[0x80];
+		if(length >= sizeof(buffer)) {
+			return false;
+		}
+
+		std::memcpy(buffer, pValue, length);
+		buffer[length] = '\0';
+
+		return TryParse(buffer, outValue);
+	}
 };
 
 // Specializations
@@ -150,18 +180,22 @@ public:
 // functions will eventually call them.
 
 template<>
-static bool Parser<bool>::TryParse(const char* pValue, OutType* outValue) {
-	switch(toupper(static_cast<unsigned char>(*pValue))) {
+static bool Parser<bool>::TryParsePart(const char* pValue, size_t length, OutType* outValue) {
+	if(!length) {
+		return false;
+	}
+
+	switch(ParserDetail::ToLower(*pValue)) {
 		case '1':
-		case 'T':
-		case 'Y':
+		case 't':
+		case 'y':
 			if(outValue) {
 				*outValue = true;
 			}
 			return true;
 		case '0':
-		case 'F':
-		case 'N':
+		case 'f':
+		case 'n':
 			if(outValue) {
 				*outValue = false;
 			}
@@ -172,18 +206,14 @@ static bool Parser<bool>::TryParse(const char* pValue, OutType* outValue) {
 };
 
 template<>
-static bool Parser<int>::TryParse(const char* pValue, OutType* outValue) {
-	const char *pFmt = nullptr;
-	if(*pValue == '$') {
-		pFmt = "$%d";
-	} else if(tolower(static_cast<unsigned char>(pValue[strlen(pValue) - 1])) == 'h') {
-		pFmt = "%xh";
-	} else {
-		pFmt = "%d";
-	}
+static bool Parser<bool>::TryParse(const char* pValue, OutType* outValue) {
+	return TryParsePart(pValue, strlen(pValue), outValue);
+};
 
+template<>
+static bool Parser<int>::TryParsePart(const char* pValue, size_t length, OutType* outValue) {
 	int buffer = 0;
-	if(sscanf_s(pValue, pFmt, &buffer) == 1) {
+	if(ParserDetail::ReadInteger(pValue, pValue + length, buffer)) {
 		if(outValue) {
 			*outValue = buffer;
 		}
@@ -193,10 +223,15 @@ static bool Parser<int>::TryParse(const char* pValue, OutType* outValue) {
 }
 
 template<>
-static bool Parser<double>::TryParse(const char* pValue, OutType* outValue) {
+static bool Parser<int>::TryParse(const char* pValue, OutType* outValue) {
+	return TryParsePart(pValue, strlen(pValue), outValue);
+}
+
+template<>
+static bool Parser<double>::TryParsePart(const char* pValue, size_t length, OutType* outValue) {
 	double buffer = 0.0;
-	if(sscanf_s(pValue, "%lf", &buffer) == 1) {
-		if(strchr(pValue, '%')) {
+	if(ParserDetail::ReadDouble(pValue, pValue + length, buffer)) {
+		if(std::memchr(pValue, '%', length)) {
 			buffer *= 0.01;
 		}
 		if(outValue) {
@@ -208,9 +243,14 @@ static bool Parser<double>::TryParse(const char* pValue, OutType* outValue) {
 };
 
 template<>
-static bool Parser<float>::TryParse(const char* pValue, OutType* outValue) {
+static bool Parser<double>::TryParse(const char* pValue, OutType* outValue) {
+	return TryParsePart(pValue, strlen(pValue), outValue);
+};
+
+template<>
+static bool Parser<float>::TryParsePart(const char* pValue, size_t length, OutType* outValue) {
 	double buffer = 0.0;
-	if(Parser<double>::TryParse(pValue, &buffer)) {
+	if(Parser<double>::TryParsePart(pValue, length, &buffer)) {
 		if(outValue) {
 			*outValue = static_cast<float>(buffer);
 		}
@@ -220,20 +260,15 @@ static bool Parser<float>::TryParse(const char* pValue, OutType* outValue) {
 }
 
 template<>
-static bool Parser<BYTE>::TryParse(const char* pValue, OutType* outValue) {
-	// no way to read unsigned char, use short instead.
-	const char *pFmt = nullptr;
-	if(*pValue == '$') {
-		pFmt = "$%hu";
-	} else if(tolower(static_cast<unsigned char>(pValue[strlen(pValue) - 1])) == 'h') {
-		pFmt = "%hxh";
-	} else {
-		pFmt = "%hu";
-	}
+static bool Parser<float>::TryParse(const char* pValue, OutType* outValue) {
+	return TryParsePart(pValue, strlen(pValue), outValue);
+}
 
-	WORD buffer;
-	if(sscanf_s(pValue, pFmt, &buffer) == 1) {
-		if(buffer <= UCHAR_MAX) {
+template<>
+static bool Parser<BYTE>::TryParsePart(const char* pValue, size_t length, OutType* outValue) {
+	int buffer = 0;
+	if(ParserDetail::ReadInteger(pValue, pValue + length, buffer)) {
+		if(buffer >= 0 && buffer <= UCHAR_MAX) {
 			if(outValue) {
 				*outValue = static_cast<BYTE>(buffer);
 			}
@@ -242,3 +277,8 @@ static bool Parser<BYTE>::TryParse(const char* pValue, OutType* outValue) {
 	}
 	return false;
 };
+
+template<>
+static bool Parser<BYTE>::TryParse(const char* pValue, OutType* outValue) {
+	return TryParsePart(pValue, strlen(pValue), outValue);
+};
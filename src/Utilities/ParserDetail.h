@@ -0,0 +1,215 @@
+#pragma once
+
+#include <clocale>
+#include <cstdint>
+#include <cstdlib>
+#include <locale.h>
+
+// Low-level scanners used by the Parser specializations. They work on the
+// range [pBegin, pEnd) of a buffer without copying it and do not depend on
+// the CRT locale. They accept the same input the sscanf formats did.
+// This header must not depend on the game, so the benchmark in tools/parser
+// can include it on any platform.
+namespace ParserDetail {
+	inline bool IsSpace(char c) {
+		return c == ' ' || (c >= '\t' && c <= '\r');
+	}
+
+	inline const char* SkipSpace(const char* pBegin, const char* pEnd) {
+		while(pBegin != pEnd && IsSpace(*pBegin)) {
+			++pBegin;
+		}
+		return pBegin;
+	}
+
+	//! strtod in the "C" locale, so the decimal separator is always a dot.
+	inline double StrToDouble(const char* pNumber, char** ppEnd) {
+#ifdef _MSC_VER
+		static _locale_t const CLocale = _create_locale(LC_NUMERIC, "C");
+		return _strtod_l(pNumber, ppEnd, CLocale);
+#else
+		static locale_t const CLocale = newlocale(LC_NUMERIC_MASK, "C", nullptr);
+		return strtod_l(pNumber, ppEnd, CLocale);
+#endif
+	}
+
+	//! Reads a number with strtod, if it starts with one.
+	inline bool ReadDoubleCRT(const char* pNumber, double& value) {
+		char* pRead = nullptr;
+		auto const result = StrToDouble(pNumber, &pRead);
+		if(pRead == pNumber) {
+			return false;
+		}
+		value = result;
+		return true;
+	}
+
+	inline char ToLower(char c) {
+		return (c >= 'A' && c <= 'Z') ? static_cast<char>(c | 0x20) : c;
+	}
+
+	inline unsigned int DigitValue(char c) {
+		if(c >= '0' && c <= '9') {
+			return static_cast<unsigned int>(c - '0');
+		}
+		auto const lower = ToLower(c);
+		if(lower >= 'a' && lower <= 'z') {
+			return static_cast<unsigned int>(lower - 'a' + 10);
+		}
+		return 36;
+	}
+
+	//! Reads an optionally signed integer like "%d" or "%x" would.
+	/*!
+		Leading white space is skipped, anything after the last digit is
+		ignored. Values out of range wrap around.
+
+		\returns true, if at least one digit was read, false otherwise.
+	*/
+	inline bool ReadInteger(
+		const char* pBegin, const char* pEnd, unsigned int base, int& value)
+	{
+		auto p = SkipSpace(pBegin, pEnd);
+
+		auto negative = false;
+		if(p != pEnd && (*p == '+' || *p == '-')) {
+			negative = (*p == '-');
+			++p;
+		}
+
+		// hex may be prefixed by 0x
+		if(base == 16 && pEnd - p > 2 && p[0] == '0' && ToLower(p[1]) == 'x'
+			&& DigitValue(p[2]) < 16)
+		{
+			p += 2;
+		}
+
+		auto const pDigits = p;
+		unsigned int result = 0;
+		for(unsigned int digit; p != pEnd && (digit = DigitValue(*p)) < base; ++p) {
+			result = result * base + digit;
+		}
+
+		if(p == pDigits) {
+			return false;
+		}
+
+		value = static_cast<int>(negative ? 0u - result : result);
+		return true;
+	}
+
+	//! Reads an integer in any of the INI formats: "12", "$12" and "0Ch".
+	inline bool ReadInteger(const char* pBegin, const char* pEnd, int& value) {
+		if(pBegin == pEnd) {
+			return false;
+		}
+
+		if(*pBegin == '$') {
+			return ReadInteger(pBegin + 1, pEnd, 10, value);
+		}
+
+		if(ToLower(pEnd[-1]) == 'h') {
+			return ReadInteger(pBegin, pEnd, 16, value);
+		}
+
+		return ReadInteger(pBegin, pEnd, 10, value);
+	}
+
+	//! Reads a floating point number like "%lf" would.
+	/*!
+		Numbers with up to 19 significant digits and small exponents, which
+		are all numbers found in INIs, are converted exactly without calling
+		into the CRT. Anything else is handed to strtod in the "C" locale.
+		The range has to be followed by a character that cannot continue the
+		number, as it is when it is part of a comma separated list.
+
+		\returns true, if a number was read, false otherwise.
+	*/
+	inline bool ReadDouble(const char* pBegin, const char* pEnd, double& value) {
+		static const double Powers[] = {
+			1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+		};
+
+		auto const pNumber = SkipSpace(pBegin, pEnd);
+		auto p = pNumber;
+
+		auto negative = false;
+		if(p != pEnd && (*p == '+' || *p == '-')) {
+			negative = (*p == '-');
+			++p;
+		}
+
+		uint64_t mantissa = 0;
+		auto digits = 0;
+		auto exponent = 0;
+		auto exact = true;
+
+		auto const addDigit = [&](char c) {
+			if(mantissa < 1000000000000000000ull) {
+				mantissa = mantissa * 10 + static_cast<unsigned int>(c - '0');
+				return true;
+			}
+			exact &= (c == '0');
+			return false;
+		};
+
+		// hex floats like "0x1p3" are left to strtod, as they were to sscanf
+		if(pEnd - p > 1 && p[0] == '0' && ToLower(p[1]) == 'x') {
+			return ReadDoubleCRT(pNumber, value);
+		}
+
+		for(; p != pEnd && *p >= '0' && *p <= '9'; ++p, ++digits) {
+			if(!addDigit(*p)) {
+				++exponent;
+			}
+		}
+
+		if(p != pEnd && *p == '.') {
+			for(++p; p != pEnd && *p >= '0' && *p <= '9'; ++p, ++digits) {
+				if(addDigit(*p)) {
+					--exponent;
+				}
+			}
+		}
+
+		if(!digits) {
+			// might still be something like "inf"
+			return ReadDoubleCRT(pNumber, value);
+		}
+
+		if(p != pEnd && ToLower(*p) == 'e') {
+			auto pExp = p + 1;
+			auto negativeExp = false;
+			if(pExp != pEnd && (*pExp == '+' || *pExp == '-')) {
+				negativeExp = (*pExp == '-');
+				++pExp;
+			}
+
+			if(pExp != pEnd && *pExp >= '0' && *pExp <= '9') {
+				auto exp = 0;
+				for(; pExp != pEnd && *pExp >= '0' && *pExp <= '9'; ++pExp) {
+					if(exp < 10000) {
+						exp = exp * 10 + (*pExp - '0');
+					}
+				}
+				exponent += negativeExp ? -exp : exp;
+			}
+		}
+
+		// exact if the mantissa and the power of ten are representable
+		if(exact && mantissa <= (1ull << 53) && exponent >= -22 && exponent <= 22) {
+			auto result = static_cast<double>(mantissa);
+			if(exponent < 0) {
+				result /= Powers[-exponent];
+			} else {
+				result *= Powers[exponent];
+			}
+			value = negative ? -result : result;
+			return true;
+		}
+
+		value = StrToDouble(pNumber, nullptr);
+		return true;
+	}
+}
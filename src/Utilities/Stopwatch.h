@@ -0,0 +1,29 @@
+#pragma once
+
+#include <Windows.h>
+
+// measures the wall time since construction or the last Restart, using the
+// high resolution performance counter.
+class Stopwatch {
+public:
+	Stopwatch() {
+		this->Restart();
+	}
+
+	void Restart() {
+		QueryPerformanceCounter(&this->Start);
+	}
+
+	double ElapsedMilliseconds() const {
+		LARGE_INTEGER Now;
+		LARGE_INTEGER Frequency;
+		QueryPerformanceCounter(&Now);
+		QueryPerformanceFrequency(&Frequency);
+
+		return static_cast<double>(Now.QuadPart - this->Start.QuadPart)
+			* 1000.0 / static_cast<double>(Frequency.QuadPart);
+	}
+
+private:
+	LARGE_INTEGER Start;
+};
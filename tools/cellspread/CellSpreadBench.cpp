@@ -0,0 +1,351 @@
+// cellspread - benchmarks the CellSpread MaxAffect filter
+//
+// the hook DamageArea_Damage_MaxAffect in
+// src/Ext/WarheadType/Hooks.CellSpread.cpp gets a list of damage groups, one
+// for every object in every cell in the spread, and keeps at most MaxAffect
+// groups per object, preferring the closest ones. this is a copy of that
+// code, with the game's objects replaced by plain structs, next to the
+// original game implementation. it checks that both keep the same groups,
+// then times them on
+//
+// - random lists with a given number of groups and distinct targets, and
+// - detonations on synthetic dense grids, where every cell is covered by a
+//   building foundation or holds infantry, as in a crowded base.
+//
+// this does not need the game or Windows. build it with any C++11 compiler,
+// for example from the repository root:
+//
+//   g++ -std=c++11 -O2 -Wall -o cellspread tools/cellspread/CellSpreadBench.cpp
+//
+// keep the algorithms in sync with the hook when changing either.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	struct ObjectClass {
+		int UniqueID;
+	};
+
+	struct DamageGroup {
+		ObjectClass* Target;
+		int Distance;
+	};
+
+	// Helpers::Alex::selectionsort
+	template <typename Iter, typename Pred>
+	void selectionsort(Iter first, Iter middle, Iter last, Pred pred) {
+		for(; first != middle; ++first) {
+			std::iter_swap(first, std::min_element(first, last, pred));
+		}
+	}
+
+	void RemoveEmpty(std::vector<DamageGroup*>& groups) {
+		groups.erase(std::remove(groups.begin(), groups.end(), nullptr), groups.end());
+	}
+
+	// the game's implementation: for every target not seen yet, collect
+	// its groups from the rest of the list. the game uses stack buffers, so
+	// the vectors are reused here to not time the heap.
+	void Original(std::vector<DamageGroup*>& groups, int const MaxAffect) {
+		static std::vector<ObjectClass*> handled;
+		static std::vector<DamageGroup**> target;
+		handled.clear();
+
+		for(auto& group : groups) {
+			if(group && std::find(handled.begin(), handled.end(), group->Target) == handled.end()) {
+				handled.push_back(group->Target);
+				target.clear();
+
+				for(auto it = &group; it != groups.data() + groups.size(); ++it) {
+					if(*it && (*it)->Target == group->Target) {
+						target.push_back(it);
+					}
+				}
+
+				if(static_cast<int>(target.size()) > MaxAffect) {
+					selectionsort(target.begin(), target.begin() + MaxAffect, target.end(),
+						[](DamageGroup** a, DamageGroup** b) { return (*a)->Distance < (*b)->Distance; });
+
+					for(auto it = target.begin() + MaxAffect; it != target.end(); ++it) {
+						delete **it;
+						**it = nullptr;
+					}
+				}
+			}
+		}
+
+		RemoveEmpty(groups);
+	}
+
+	// the hook, with the number of targets scanned linearly as a parameter.
+	// 0 sorts all groups, a huge number scans all targets linearly
+	void Hook(std::vector<DamageGroup*>& groups, int const MaxAffect, size_t const LinearTargets) {
+		using Item = std::pair<ObjectClass*, DamageGroup**>;
+
+		static std::vector<ObjectClass*> handled;
+		static std::vector<DamageGroup**> target;
+		static std::vector<Item> targets;
+
+		handled.clear();
+		targets.clear();
+
+		auto const limit = static_cast<ptrdiff_t>(MaxAffect);
+		auto const pEnd = groups.data() + groups.size();
+
+		auto IsHandled = [](ObjectClass* pTarget) {
+			return std::find(handled.begin(), handled.end(), pTarget) != handled.end();
+		};
+
+		auto pRest = pEnd;
+		for(auto pGroup = groups.data(); pGroup != pEnd; ++pGroup) {
+			auto const group = *pGroup;
+			if(!group || IsHandled(group->Target)) {
+				continue;
+			}
+
+			if(handled.size() == LinearTargets) {
+				pRest = pGroup;
+				break;
+			}
+
+			handled.push_back(group->Target);
+			target.clear();
+
+			for(auto it = pGroup; it != pEnd; ++it) {
+				if(*it && (*it)->Target == group->Target) {
+					target.push_back(it);
+				}
+			}
+
+			if(static_cast<ptrdiff_t>(target.size()) > limit) {
+				auto const cutoff = target.begin() + limit;
+				selectionsort(target.begin(), cutoff, target.end(),
+					[](DamageGroup** a, DamageGroup** b) { return (*a)->Distance < (*b)->Distance; });
+
+				for(auto it = cutoff; it != target.end(); ++it) {
+					delete **it;
+					**it = nullptr;
+				}
+			}
+		}
+
+		for(auto pGroup = pRest; pGroup != pEnd; ++pGroup) {
+			if(*pGroup && !IsHandled((*pGroup)->Target)) {
+				targets.emplace_back((*pGroup)->Target, pGroup);
+			}
+		}
+
+		std::sort(targets.begin(), targets.end(), [](Item const& lhs, Item const& rhs) {
+			auto const lhsID = lhs.first->UniqueID;
+			auto const rhsID = rhs.first->UniqueID;
+			if(lhsID != rhsID) {
+				return lhsID < rhsID;
+			}
+			return lhs.second < rhs.second;
+		});
+
+		for(auto it = targets.begin(); it != targets.end();) {
+			auto const pTarget = it->first;
+			auto const last = std::find_if(it, targets.end(), [pTarget](Item const& item) {
+				return item.first != pTarget;
+			});
+
+			if(std::distance(it, last) > limit) {
+				auto const cutoff = it + limit;
+				selectionsort(it, cutoff, last, [](Item const& lhs, Item const& rhs) {
+					return (*lhs.second)->Distance < (*rhs.second)->Distance;
+				});
+
+				for(auto del = cutoff; del != last; ++del) {
+					delete *del->second;
+					*del->second = nullptr;
+				}
+			}
+
+			it = last;
+		}
+
+		RemoveEmpty(groups);
+	}
+
+	std::mt19937 Random(1);
+	std::vector<ObjectClass> Objects(20000);
+
+	// n groups hitting one of count targets each, at one of four distances,
+	// so there are many ties
+	std::vector<DamageGroup*> MakeRandom(int const n, int const count) {
+		std::vector<DamageGroup*> ret;
+		for(auto i = 0; i < n; ++i) {
+			auto const pTarget = &Objects[Random() % static_cast<unsigned int>(count)];
+			ret.push_back(new DamageGroup{pTarget, static_cast<int>(Random() % 4) * 256});
+		}
+		return ret;
+	}
+
+	// a detonation in the middle of a dense grid. the cells are scanned ring
+	// by ring like CellSpreadEnumerator does. buildings are size x size
+	// squares and hit once per covered cell, every other cell holds three
+	// infantry.
+	std::vector<DamageGroup*> MakeGrid(int const spread, int const size) {
+		std::vector<std::pair<int, int>> cells;
+		for(auto y = -spread; y <= spread; ++y) {
+			for(auto x = -spread; x <= spread; ++x) {
+				if(x * x + y * y <= spread * spread) {
+					cells.emplace_back(x, y);
+				}
+			}
+		}
+		std::stable_sort(cells.begin(), cells.end(), [](std::pair<int, int> const& a, std::pair<int, int> const& b) {
+			return std::max(std::abs(a.first), std::abs(a.second)) < std::max(std::abs(b.first), std::abs(b.second));
+		});
+
+		std::vector<DamageGroup*> ret;
+		auto const offset = spread + 8;
+		auto const width = 2 * offset;
+		for(auto const& cell : cells) {
+			auto const x = cell.first + offset;
+			auto const y = cell.second + offset;
+			auto const distance = static_cast<int>(256 * std::sqrt(cell.first * cell.first + cell.second * cell.second));
+
+			// half of the grid is covered by buildings
+			if(((x / size) + (y / size)) % 2 == 0) {
+				auto const id = (y / size) * width + (x / size);
+				ret.push_back(new DamageGroup{&Objects[static_cast<size_t>(id)], distance});
+			} else {
+				for(auto i = 0; i < 3; ++i) {
+					auto const id = 10000 + (y * width + x) * 3 + i;
+					ret.push_back(new DamageGroup{&Objects[static_cast<size_t>(id) % Objects.size()], distance});
+				}
+			}
+		}
+
+		return ret;
+	}
+
+	std::vector<DamageGroup*> Copy(std::vector<DamageGroup*> const& groups) {
+		std::vector<DamageGroup*> ret;
+		for(auto const pGroup : groups) {
+			ret.push_back(new DamageGroup(*pGroup));
+		}
+		return ret;
+	}
+
+	std::vector<size_t> Kept(std::vector<DamageGroup*> const& original, std::vector<DamageGroup*> const& result) {
+		std::vector<size_t> ret;
+		for(auto const pGroup : result) {
+			ret.push_back(static_cast<size_t>(std::find(original.begin(), original.end(), pGroup) - original.begin()));
+		}
+		return ret;
+	}
+
+	void Free(std::vector<DamageGroup*>& groups) {
+		for(auto const pGroup : groups) {
+			delete pGroup;
+		}
+		groups.clear();
+	}
+
+	template <typename Make, typename Filter>
+	double Time(Make make, Filter filter, int const reps) {
+		auto total = 0.0;
+		Random.seed(7);
+		for(auto i = 0; i < reps; ++i) {
+			auto groups = make();
+			auto const start = std::chrono::steady_clock::now();
+			filter(groups);
+			total += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+			Free(groups);
+		}
+		return total / reps;
+	}
+
+	const size_t Thresholds[] = {0, 4, 8, 16, 32, 1000000};
+
+	template <typename Make>
+	void Report(const char* pName, Make make, int const groupsHint, int const MaxAffect) {
+		auto const reps = std::max(50, 2000000 / std::max(groupsHint, 1));
+		std::printf("%-28s game %9.2f us", pName,
+			Time(make, [=](std::vector<DamageGroup*>& g) { Original(g, MaxAffect); }, reps));
+		for(auto const threshold : Thresholds) {
+			std::printf(" | %7.2f", Time(make, [=](std::vector<DamageGroup*>& g) { Hook(g, MaxAffect, threshold); }, reps));
+		}
+		std::printf("\n");
+	}
+}
+
+int main() {
+	for(size_t i = 0; i < Objects.size(); ++i) {
+		Objects[i].UniqueID = static_cast<int>((i * 7919) % Objects.size());
+	}
+
+	// all variants have to keep the same groups as the game
+	for(auto run = 0; run < 2000; ++run) {
+		auto const n = 1 + static_cast<int>(Random() % 300);
+		auto const count = 1 + static_cast<int>(Random() % 60);
+		auto const MaxAffect = static_cast<int>(Random() % 6);
+
+		auto original = MakeRandom(n, count);
+		auto const expected = Copy(original);
+		auto result = original;
+		Original(result, MaxAffect);
+		auto const kept = Kept(original, result);
+		Free(result);
+
+		for(auto const threshold : Thresholds) {
+			auto copy = Copy(expected);
+			auto other = copy;
+			Hook(other, MaxAffect, threshold);
+			if(Kept(copy, other) != kept) {
+				std::printf("mismatch in run %d, linear targets %u\n", run, static_cast<unsigned int>(threshold));
+				return 1;
+			}
+			Free(other);
+		}
+
+		auto remaining = expected;
+		Free(remaining);
+	}
+	std::printf("all variants keep the same groups as the game in 2000 runs\n\n");
+
+	std::printf("%-28s %17s", "MaxAffect 3, per call", "");
+	for(auto const threshold : Thresholds) {
+		if(!threshold) {
+			std::printf(" | %7s", "sorted");
+		} else if(threshold > 1000) {
+			std::printf(" | %7s", "linear");
+		} else {
+			std::printf(" | lin %3u", static_cast<unsigned int>(threshold));
+		}
+	}
+	std::printf("\n");
+
+	char name[64];
+	for(auto const n : {50, 200, 1000}) {
+		for(auto const count : {5, 50, 200}) {
+			std::snprintf(name, sizeof(name), "random %4d groups %3d targets", n, count);
+			Report(name, [=]() { return MakeRandom(n, count); }, n, 3);
+		}
+	}
+
+	for(auto const spread : {2, 4, 6, 10}) {
+		for(auto const size : {2, 4}) {
+			auto const sample = MakeGrid(spread, size);
+			auto const n = static_cast<int>(sample.size());
+			auto copy = sample;
+			Free(copy);
+			std::snprintf(name, sizeof(name), "grid spread %2d, %dx%d (%d)", spread, size, size, n);
+			Report(name, [=]() { return MakeGrid(spread, size); }, n, 3);
+		}
+	}
+
+	return 0;
+}
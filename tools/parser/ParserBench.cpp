@@ -0,0 +1,229 @@
+// parser - compares the INI number scanners with the sscanf path they replace
+//
+// Parser<T, N> in src/Utilities/Parser.h splits comma separated INI values
+// and reads ints and doubles with the scanners in ParserDetail.h. before,
+// every element was copied out with sscanf("%[^,]%n") and read with the
+// sscanf formats "$%d", "%xh", "%d" and "%lf". this checks that both read
+// the same values from a set of inputs, then times both on typical lists.
+//
+// the old path is timed with this platform's sscanf, not the game's CRT, so
+// the absolute numbers differ from the game. the sscanf formats are the same.
+//
+// this does not need the game or Windows. build it with any C++11 compiler,
+// for example from the repository root:
+//
+//   g++ -std=c++11 -O2 -Wall -o parser tools/parser/ParserBench.cpp
+
+#include "../../src/Utilities/ParserDetail.h"
+
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	// the old Parser<T, N>::Parse and Parser<T>::TryParse
+	namespace Old
+	{
+		bool ReadInt(const char* pValue, int& value) {
+			const char* pFmt = nullptr;
+			if(*pValue == '$') {
+				pFmt = "$%d";
+			} else if(std::tolower(static_cast<unsigned char>(pValue[std::strlen(pValue) - 1])) == 'h') {
+				pFmt = "%xh";
+			} else {
+				pFmt = "%d";
+			}
+			return std::sscanf(pValue, pFmt, &value) == 1;
+		}
+
+		bool ReadDouble(const char* pValue, double& value) {
+			if(std::sscanf(pValue, "%lf", &value) == 1) {
+				if(std::strchr(pValue, '%')) {
+					value *= 0.01;
+				}
+				return true;
+			}
+			return false;
+		}
+
+		template <typename T, typename Read>
+		size_t Parse(const char* pValue, T* pOut, size_t count, Read read) {
+			char buffer[0x80];
+			for(size_t i = 0; i < count; ++i) {
+				while(std::isspace(static_cast<unsigned char>(*pValue))) {
+					++pValue;
+				}
+
+				int n = 0;
+				if(std::sscanf(pValue, "%127[^,]%n", buffer, &n) != 1) {
+					return i;
+				}
+
+				pValue += n;
+				if(*pValue) {
+					++pValue;
+				}
+
+				while(n && std::isspace(static_cast<unsigned char>(buffer[n - 1]))) {
+					buffer[n-- - 1] = '\0';
+				}
+
+				if(!read(buffer, pOut[i])) {
+					return i;
+				}
+			}
+			return count;
+		}
+	}
+
+	// Parser<T, N>::Parse and the int and double TryParsePart
+	namespace New
+	{
+		bool ReadInt(const char* pValue, size_t length, int& value) {
+			return ParserDetail::ReadInteger(pValue, pValue + length, value);
+		}
+
+		bool ReadDouble(const char* pValue, size_t length, double& value) {
+			if(ParserDetail::ReadDouble(pValue, pValue + length, value)) {
+				if(std::memchr(pValue, '%', length)) {
+					value *= 0.01;
+				}
+				return true;
+			}
+			return false;
+		}
+
+		template <typename T, typename Read>
+		size_t Parse(const char* pValue, T* pOut, size_t count, Read read) {
+			for(size_t i = 0; i < count; ++i) {
+				while(ParserDetail::IsSpace(*pValue)) {
+					++pValue;
+				}
+
+				auto pEnd = pValue;
+				while(*pEnd && *pEnd != ',') {
+					++pEnd;
+				}
+
+				if(pEnd == pValue) {
+					return i;
+				}
+
+				auto const pNext = *pEnd ? pEnd + 1 : pEnd;
+
+				while(pEnd != pValue && ParserDetail::IsSpace(pEnd[-1])) {
+					--pEnd;
+				}
+
+				if(!read(pValue, static_cast<size_t>(pEnd - pValue), pOut[i])) {
+					return i;
+				}
+
+				pValue = pNext;
+			}
+			return count;
+		}
+	}
+
+	const char* const Ints[] = {
+		"0", "1", "-1", "+7", "  42  ", "100,200,300", "$12", "$-5", "0Ch",
+		"0FFh", "7fh", "2147483647", "-2147483648", "12abc", "abc", "",
+		" , ", "1, 2 ,3", "0x10h", "-0Ah"
+	};
+
+	const char* const Doubles[] = {
+		"0", "1", "-1", "0.5", ".5", "5.", "1.25,2.5,3.75", "  3.14159  ",
+		"25%", "150 %", "1e3", "1.5E-2", "-2.5e+1", "0.1", "0.3",
+		"123456789.123456789", "1e300", "1e-300", "12345678901234567890123",
+		"0.000000000000000000001", "inf", "-inf", "nan", "0x1p3", "0X1.8p1",
+		"-0x10", "abc", "", " , ", "1.5abc", "0.333333333333333333333333"
+	};
+
+	bool Same(double a, double b) {
+		return (std::isnan(a) && std::isnan(b)) || a == b;
+	}
+
+	template <typename Func>
+	double Time(Func func, int const reps) {
+		auto const start = std::chrono::steady_clock::now();
+		for(auto i = 0; i < reps; ++i) {
+			func();
+		}
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / reps;
+	}
+
+	volatile double Sink;
+}
+
+int main() {
+	auto failures = 0;
+
+	for(auto const pValue : Ints) {
+		int a[3] = {}, b[3] = {};
+		auto const na = Old::Parse(pValue, a, 3, Old::ReadInt);
+		auto const nb = New::Parse(pValue, b, 3, New::ReadInt);
+		if(na != nb || std::memcmp(a, b, sizeof(a))) {
+			std::printf("int mismatch for \"%s\": %u values %d %d %d, now %u values %d %d %d\n",
+				pValue, static_cast<unsigned int>(na), a[0], a[1], a[2],
+				static_cast<unsigned int>(nb), b[0], b[1], b[2]);
+			++failures;
+		}
+	}
+
+	for(auto const pValue : Doubles) {
+		double a[3] = {}, b[3] = {};
+		auto const na = Old::Parse(pValue, a, 3, Old::ReadDouble);
+		auto const nb = New::Parse(pValue, b, 3, New::ReadDouble);
+		if(na != nb || !Same(a[0], b[0]) || !Same(a[1], b[1]) || !Same(a[2], b[2])) {
+			std::printf("double mismatch for \"%s\": %u values %.17g %.17g %.17g, now %u values %.17g %.17g %.17g\n",
+				pValue, static_cast<unsigned int>(na), a[0], a[1], a[2],
+				static_cast<unsigned int>(nb), b[0], b[1], b[2]);
+			++failures;
+		}
+	}
+
+	std::printf("%u int and %u double inputs, %d differences\n\n",
+		static_cast<unsigned int>(sizeof(Ints) / sizeof(*Ints)),
+		static_cast<unsigned int>(sizeof(Doubles) / sizeof(*Doubles)), failures);
+
+	struct Case {
+		const char* Name;
+		const char* Value;
+		bool IsDouble;
+		size_t Count;
+	};
+
+	const Case Cases[] = {
+		{"int", "150", false, 1},
+		{"int $", "$12", false, 1},
+		{"int hex", "0C8h", false, 1},
+		{"int list of 3", "100,200,300", false, 3},
+		{"double", "0.75", true, 1},
+		{"double percent", "25%", true, 1},
+		{"double list of 3", "1.25, 2.5, 3.75", true, 3},
+		{"double exponent", "1.5e-2", true, 1},
+	};
+
+	auto const reps = 1000000;
+	std::printf("%-20s %12s %12s\n", "ns per call", "sscanf", "scanners");
+	for(auto const& item : Cases) {
+		double oldTime = 0.0;
+		double newTime = 0.0;
+		if(item.IsDouble) {
+			double out[3];
+			oldTime = Time([&]() { Old::Parse(item.Value, out, item.Count, Old::ReadDouble); Sink = out[0]; }, reps);
+			newTime = Time([&]() { New::Parse(item.Value, out, item.Count, New::ReadDouble); Sink = out[0]; }, reps);
+		} else {
+			int out[3];
+			oldTime = Time([&]() { Old::Parse(item.Value, out, item.Count, Old::ReadInt); Sink = out[0]; }, reps);
+			newTime = Time([&]() { New::Parse(item.Value, out, item.Count, New::ReadInt); Sink = out[0]; }, reps);
+		}
+		std::printf("%-20s %12.1f %12.1f\n", item.Name, oldTime, newTime);
+	}
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,391 @@
+// syncdiff - compares binary synchronization logs written by Ares
+//
+// start the game with -BINARYSYNC to have it write SYNC*.BIN instead of the
+// text logs when a desync is detected. collect the files of all players and
+// run
+//
+//   syncdiff SYNC0.BIN SYNC1.BIN [more logs...]
+//
+// to find the first frame whose checksum differs and the first object whose
+// state differs. the first log is the reference all others are compared to.
+// the exit code is 0 if the logs agree, 1 if they diverge and 2 on errors.
+//
+// this does not need the game or Windows. build it with any C++11 compiler,
+// for example from the repository root:
+//
+//   g++ -std=c++11 -O2 -Wall -o syncdiff tools/syncdiff/SyncDiff.cpp
+
+#include "../../src/Misc/SyncLogFormat.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	struct Log {
+		std::string FileName;
+		SyncLog::Header Header;
+		std::map<uint8_t, std::string> Classes;
+		std::map<int32_t, uint32_t> Frames;
+		std::map<std::pair<uint8_t, int32_t>, SyncLog::TypeRecord> Types;
+		std::vector<SyncLog::ObjectRecord> Objects;
+
+		// object key to index in Objects
+		std::map<std::pair<uint8_t, uint32_t>, size_t> ObjectsByKey;
+
+		std::string GetClassName(uint8_t const what) const {
+			auto const it = this->Classes.find(what);
+			if(it != this->Classes.end()) {
+				return it->second;
+			}
+			return "Class" + std::to_string(what);
+		}
+
+		std::string GetTypeID(uint8_t const what, int32_t const index) const {
+			if(index < 0) {
+				return "<None>";
+			}
+
+			auto const it = this->Types.find(std::make_pair(what, index));
+			if(it != this->Types.end()) {
+				return std::string(it->second.ID, strnlen(it->second.ID, sizeof(it->second.ID)));
+			}
+			return "#" + std::to_string(index);
+		}
+	};
+
+	std::string ToHex(uint32_t const value) {
+		char buffer[9];
+		snprintf(buffer, sizeof(buffer), "%08" PRIX32, value);
+		return buffer;
+	}
+
+	// houses are identified by their index, everything else by unique id
+	std::pair<uint8_t, uint32_t> GetKey(SyncLog::ObjectRecord const& record) {
+		if(record.List == static_cast<uint8_t>(SyncLog::List::Houses)) {
+			return std::make_pair(record.List, static_cast<uint32_t>(record.Index));
+		}
+		return std::make_pair(record.List, record.UniqueID);
+	}
+
+	const char* GetListName(uint8_t const list) {
+		switch(static_cast<SyncLog::List>(list)) {
+		case SyncLog::List::Houses:
+			return "Houses";
+		case SyncLog::List::Abstracts:
+			return "Abstracts";
+		default:
+			return "Unknown";
+		}
+	}
+
+	template<typename T>
+	bool ReadRecords(FILE* const F, uint32_t const count, std::vector<T>& records) {
+		records.resize(count);
+		return !count || fread(records.data(), sizeof(T), count, F) == count;
+	}
+
+	// whether the records the header announces fit into the rest of the file.
+	// checked before anything is allocated, so corrupt counts are rejected.
+	bool FitsFile(FILE* const F, SyncLog::Header const& header) {
+		auto const pos = ftell(F);
+		if(pos < 0 || fseek(F, 0, SEEK_END)) {
+			return false;
+		}
+		auto const end = ftell(F);
+		if(end < pos || fseek(F, pos, SEEK_SET)) {
+			return false;
+		}
+
+		auto const needed =
+			static_cast<uint64_t>(header.ClassCount) * sizeof(SyncLog::ClassRecord)
+			+ static_cast<uint64_t>(header.FrameCount) * sizeof(SyncLog::FrameRecord)
+			+ static_cast<uint64_t>(header.TypeCount) * sizeof(SyncLog::TypeRecord)
+			+ static_cast<uint64_t>(header.ObjectCount) * sizeof(SyncLog::ObjectRecord);
+
+		return needed <= static_cast<uint64_t>(end - pos);
+	}
+
+	bool ReadLog(const char* const pFileName, Log& log) {
+		log.FileName = pFileName;
+
+		FILE* F = fopen(pFileName, "rb");
+		if(!F) {
+			fprintf(stderr, "%s: cannot open file\n", pFileName);
+			return false;
+		}
+
+		auto& header = log.Header;
+		auto valid = fread(&header, sizeof(header), 1, F) == 1
+			&& !memcmp(header.Magic, SyncLog::Magic, sizeof(SyncLog::Magic));
+
+		if(!valid) {
+			fprintf(stderr, "%s: not a binary sync log\n", pFileName);
+		} else if(header.Version != SyncLog::Version) {
+			fprintf(stderr, "%s: unsupported version %" PRIu32 ", expected %" PRIu32 "\n",
+				pFileName, header.Version, SyncLog::Version);
+			valid = false;
+		} else if(!FitsFile(F, header)) {
+			fprintf(stderr, "%s: record counts exceed the file size\n", pFileName);
+			valid = false;
+		}
+
+		std::vector<SyncLog::ClassRecord> classes;
+		std::vector<SyncLog::FrameRecord> frames;
+		std::vector<SyncLog::TypeRecord> types;
+
+		if(valid) {
+			valid = ReadRecords(F, header.ClassCount, classes)
+				&& ReadRecords(F, header.FrameCount, frames)
+				&& ReadRecords(F, header.TypeCount, types)
+				&& ReadRecords(F, header.ObjectCount, log.Objects);
+
+			if(!valid) {
+				fprintf(stderr, "%s: file is truncated\n", pFileName);
+			}
+		}
+
+		fclose(F);
+
+		if(!valid) {
+			return false;
+		}
+
+		for(auto const& record : classes) {
+			log.Classes[record.What] = std::string(
+				record.Name, strnlen(record.Name, sizeof(record.Name)));
+		}
+
+		for(auto const& record : frames) {
+			log.Frames[record.Frame] = record.CRC;
+		}
+
+		for(auto const& record : types) {
+			log.Types[std::make_pair(record.What, record.Index)] = record;
+		}
+
+		for(size_t i = 0; i < log.Objects.size(); ++i) {
+			log.ObjectsByKey[GetKey(log.Objects[i])] = i;
+		}
+
+		return true;
+	}
+
+	void PrintObject(Log const& log, SyncLog::ObjectRecord const& record) {
+		printf("  %-24s checksum %08" PRIX32 ", type %s, coords %" PRId32 ",%" PRId32 ",%" PRId32
+			", %s %" PRId32 "%s\n",
+			log.FileName.c_str(), record.Checksum,
+			log.GetTypeID(record.TypeWhat, record.TypeIndex).c_str(),
+			record.X, record.Y, record.Z,
+			record.List == static_cast<uint8_t>(SyncLog::List::Houses) ? "money" : "health",
+			record.Value, record.InLimbo ? ", in limbo" : "");
+	}
+
+	bool ObjectsDiffer(SyncLog::ObjectRecord const& a, SyncLog::ObjectRecord const& b) {
+		return a.Checksum != b.Checksum || a.What != b.What
+			|| a.TypeWhat != b.TypeWhat || a.TypeIndex != b.TypeIndex
+			|| a.X != b.X || a.Y != b.Y || a.Z != b.Z
+			|| a.Value != b.Value || a.InLimbo != b.InLimbo;
+	}
+
+	// returns whether the frame checksums differ
+	bool CompareFrames(std::vector<Log> const& logs) {
+		auto const& reference = logs.front();
+
+		auto first = INT32_MAX;
+		auto last = INT32_MIN;
+		auto compared = 0;
+
+		for(auto const& frame : reference.Frames) {
+			auto common = true;
+			auto differ = false;
+
+			for(size_t i = 1; i < logs.size(); ++i) {
+				auto const it = logs[i].Frames.find(frame.first);
+				if(it == logs[i].Frames.end()) {
+					common = false;
+					break;
+				}
+				differ |= it->second != frame.second;
+			}
+
+			if(!common) {
+				continue;
+			}
+
+			if(differ) {
+				if(compared) {
+					printf("Frame checksums agree from frame %d to %d.\n", first, last);
+				}
+				printf("First divergent frame: %" PRId32 "\n", frame.first);
+				for(auto const& log : logs) {
+					printf("  %-24s CRC %08" PRIX32 "\n",
+						log.FileName.c_str(), log.Frames.at(frame.first));
+				}
+				return true;
+			}
+
+			first = std::min(first, frame.first);
+			last = std::max(last, frame.first);
+			++compared;
+		}
+
+		if(compared) {
+			printf("Frame checksums agree from frame %d to %d.\n", first, last);
+		} else {
+			printf("The logs have no frames in common.\n");
+		}
+		return false;
+	}
+
+	// returns whether any type checksum differs
+	bool CompareTypes(std::vector<Log> const& logs) {
+		auto const& reference = logs.front();
+		auto differing = 0;
+
+		for(auto const& type : reference.Types) {
+			for(size_t i = 1; i < logs.size(); ++i) {
+				auto const& log = logs[i];
+				auto const it = log.Types.find(type.first);
+
+				if(it == log.Types.end() || it->second.Checksum != type.second.Checksum) {
+					if(!differing) {
+						printf("Types with different checksums (game data differs):\n");
+					}
+					printf("  %s %s: %08" PRIX32 " in %s, %s in %s\n",
+						reference.GetClassName(type.first.first).c_str(),
+						reference.GetTypeID(type.first.first, type.first.second).c_str(),
+						type.second.Checksum, reference.FileName.c_str(),
+						it == log.Types.end() ? "missing"
+							: ToHex(it->second.Checksum).c_str(),
+						log.FileName.c_str());
+					++differing;
+					break;
+				}
+			}
+		}
+
+		return differing > 0;
+	}
+
+	// returns whether any object differs
+	bool CompareObjects(std::vector<Log> const& logs) {
+		auto const& reference = logs.front();
+		auto differing = 0u;
+
+		for(auto const& record : reference.Objects) {
+			auto const key = GetKey(record);
+			auto differ = false;
+
+			for(size_t i = 1; i < logs.size(); ++i) {
+				auto const& log = logs[i];
+				auto const it = log.ObjectsByKey.find(key);
+				if(it == log.ObjectsByKey.end()
+					|| ObjectsDiffer(record, log.Objects[it->second]))
+				{
+					differ = true;
+					break;
+				}
+			}
+
+			if(!differ) {
+				continue;
+			}
+
+			if(!differing) {
+				printf("First divergent object: %s #%" PRId32 " (%s, unique id %" PRIu32 ")\n",
+					GetListName(record.List), record.Index,
+					reference.GetClassName(record.What).c_str(), record.UniqueID);
+
+				for(auto const& log : logs) {
+					auto const it = log.ObjectsByKey.find(key);
+					if(it != log.ObjectsByKey.end()) {
+						PrintObject(log, log.Objects[it->second]);
+					} else {
+						printf("  %-24s missing\n", log.FileName.c_str());
+					}
+				}
+			}
+
+			++differing;
+		}
+
+		// objects the reference does not know about
+		auto missing = 0u;
+		for(size_t i = 1; i < logs.size(); ++i) {
+			for(auto const& record : logs[i].Objects) {
+				if(!reference.ObjectsByKey.count(GetKey(record))) {
+					++missing;
+				}
+			}
+		}
+
+		if(differing) {
+			printf("%u objects differ in total.\n", differing);
+		}
+
+		if(missing) {
+			printf("%u objects are missing in %s.\n", missing, reference.FileName.c_str());
+		}
+
+		if(!differing && !missing) {
+			printf("All %u objects agree.\n", static_cast<unsigned int>(reference.Objects.size()));
+		}
+
+		return differing || missing;
+	}
+}
+
+int main(int argc, char** argv) {
+	if(argc < 3) {
+		fprintf(stderr, "usage: %s <log> <log> [more logs...]\n", argv[0]);
+		return 2;
+	}
+
+	std::vector<Log> logs(static_cast<size_t>(argc - 1));
+	for(int i = 1; i < argc; ++i) {
+		if(!ReadLog(argv[i], logs[static_cast<size_t>(i - 1)])) {
+			return 2;
+		}
+	}
+
+	for(auto const& log : logs) {
+		auto const& header = log.Header;
+		printf("%s: Ares %.*s, frame %" PRId32 ", player %" PRId32 ", random %08" PRIX32,
+			log.FileName.c_str(), static_cast<int>(sizeof(header.AresVersion)),
+			header.AresVersion, header.Frame, header.PlayerIndex, header.Random);
+
+		if(header.HasEvent) {
+			printf(", offending event %" PRId32 " of house %" PRId32 " in frame %" PRId32
+				" with CRC %08" PRIX32, header.EventKind, header.EventHouse,
+				header.EventFrame, header.EventChecksum);
+		}
+
+		printf("\n");
+	}
+
+	printf("\n");
+
+	auto diverged = CompareFrames(logs);
+	diverged |= CompareTypes(logs);
+
+	// objects can only be compared if the logs were written in the same frame
+	auto sameFrame = true;
+	for(auto const& log : logs) {
+		sameFrame &= log.Header.Frame == logs.front().Header.Frame;
+	}
+
+	if(sameFrame) {
+		diverged |= CompareObjects(logs);
+	} else {
+		printf("The logs were written in different frames, objects are not compared.\n");
+	}
+
+	return diverged ? 1 : 0;
+}